@@ -0,0 +1,214 @@
+// Batched Lookup Benchmark
+// Fills tables from cache-resident up to well past the last-level cache
+// (half full, wyhash + linear probing) and times searchBatch/insertBatch at
+// several batch sizes, with prefetching on and off, against one-at-a-time
+// search/insert. A batch also times itself once instead of once per URL,
+// so the prefetch gain column (same batch size, prefetch off vs on) is the
+// one that isolates overlapping the cache misses.
+// Results go to batch_lookup.csv
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include "include/URLHashTable.h"
+
+using namespace std;
+
+struct BatchResult {
+    int tableSize;
+    string operation;
+    int batchSize;        // 0: one call per URL
+    double mopsPerSec;    // Prefetch on
+    double nsPerOp;
+    double mopsNoPrefetch;
+    double prefetchGain;  // Time with prefetch off / time with it on
+    double vsSingle;      // Over one call per URL on the same table
+};
+
+//Distinct URLs of 30-60 bytes spread over a few thousand hosts
+vector<string> makeURLs(int count, mt19937& rng) {
+    const string chars = "abcdefghijklmnopqrstuvwxyz0123456789-_./";
+    vector<string> urls;
+    urls.reserve(count);
+    
+    for(int i = 0; i < count; i++){
+        string url = "http://www.site" + to_string(rng() % 5000) + ".com/" + to_string(i) + "/";
+        int length = 30 + rng() % 31;
+        while((int)url.size() < length){
+            url.push_back(chars[rng() % chars.size()]);
+        }
+        urls.push_back(url);
+    }
+    return urls;
+}
+
+URLHashTable* makeTable(int tableSize) {
+    URLHashTable* table = new URLHashTable(tableSize);
+    table->setHashFunction(WYHASH_HASH);
+    table->setProbingMethod(LINEAR_PROBING);
+    return table;
+}
+
+//Runs every query through search (batchSize 0) or searchBatch and returns
+//the elapsed seconds; hits are counted so the lookups cannot be dropped
+double timeSearch(URLHashTable& table, const vector<string>& queries, int batchSize, long& hits) {
+    vector<OpResult> results(batchSize > 0 ? batchSize : 1);
+    int n = queries.size();
+    
+    auto start = chrono::steady_clock::now();
+    if(batchSize == 0){
+        for(int i = 0; i < n; i++){
+            hits += table.search(queries[i]).success;
+        }
+    }
+    else{
+        for(int i = 0; i < n; i += batchSize){
+            int count = min(batchSize, n - i);
+            table.searchBatch(&queries[i], count, results.data());
+            for(int j = 0; j < count; j++){
+                hits += results[j].success;
+            }
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+//Fills a fresh table with urls through insert or insertBatch
+double timeInsert(int tableSize, const vector<string>& urls, int batchSize, bool prefetch, long& inserted) {
+    URLHashTable* table = makeTable(tableSize);
+    table->setPrefetch(prefetch);
+    vector<OpResult> results(batchSize > 0 ? batchSize : 1);
+    int n = urls.size();
+    
+    auto start = chrono::steady_clock::now();
+    if(batchSize == 0){
+        for(int i = 0; i < n; i++){
+            inserted += table->insert(urls[i]).success;
+        }
+    }
+    else{
+        for(int i = 0; i < n; i += batchSize){
+            int count = min(batchSize, n - i);
+            table->insertBatch(&urls[i], count, results.data());
+            for(int j = 0; j < count; j++){
+                inserted += results[j].success;
+            }
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    
+    delete table;
+    return chrono::duration<double>(end - start).count();
+}
+
+string formatRatio(double value) {
+    ostringstream out;
+    out << fixed << setprecision(2) << value << "x";
+    return out.str();
+}
+
+//seconds[b] / noPrefetch[b]: elapsed time at batchSizes[b] with prefetching
+//on / off (batch size 0 is the plain operation, so both are the same run)
+void addResults(vector<BatchResult>& results, int tableSize, const string& operation, const vector<int>& batchSizes,
+                const vector<double>& seconds, const vector<double>& noPrefetch, int ops) {
+    for(size_t b = 0; b < batchSizes.size(); b++){
+        BatchResult result;
+        result.tableSize = tableSize;
+        result.operation = operation;
+        result.batchSize = batchSizes[b];
+        result.mopsPerSec = ops / seconds[b] / 1e6;
+        result.nsPerOp = seconds[b] * 1e9 / ops;
+        result.mopsNoPrefetch = ops / noPrefetch[b] / 1e6;
+        result.prefetchGain = noPrefetch[b] / seconds[b];
+        result.vsSingle = seconds[0] / seconds[b];
+        results.push_back(result);
+        
+        cout << left << setw(12) << tableSize
+             << setw(10) << operation
+             << setw(10) << (batchSizes[b] == 0 ? string("single") : to_string(batchSizes[b]))
+             << setw(12) << fixed << setprecision(2) << result.mopsPerSec
+             << setw(10) << setprecision(1) << result.nsPerOp
+             << setw(12) << setprecision(2) << result.mopsNoPrefetch
+             << setw(12) << formatRatio(result.prefetchGain)
+             << formatRatio(result.vsSingle) << endl;
+    }
+}
+
+void writeCSV(const vector<BatchResult>& results, const string& filename) {
+    ofstream file(filename);
+    file << "TableSize,Operation,BatchSize,MopsPerSec,NsPerOp,MopsNoPrefetch,PrefetchGain,VsSingle\n";
+    for(const BatchResult& r : results){
+        file << r.tableSize << "," << r.operation << "," << r.batchSize << ","
+             << fixed << setprecision(4) << r.mopsPerSec << "," << r.nsPerOp << ","
+             << r.mopsNoPrefetch << "," << r.prefetchGain << "," << r.vsSingle << "\n";
+    }
+    file.close();
+    cout << "Output file created: " << filename << endl;
+}
+
+int main() {
+    cout << "Batched Lookup Benchmark" << endl;
+    cout << "(wyhash, linear probing, tables half full, 32-byte slots)" << endl << endl;
+    
+    const int tableSizes[] = {1 << 16, 1 << 20, 1 << 23};
+    const int queryCount = 1 << 21;
+    vector<int> batchSizes = {0, 1, 4, 16, 64};
+    
+    mt19937 rng(12345);
+    vector<BatchResult> results;
+    long sink = 0;
+    
+    cout << left << setw(12) << "TableSize" << setw(10) << "Op" << setw(10) << "Batch"
+         << setw(12) << "Mops/s" << setw(10) << "ns/op" << setw(12) << "No prefetch"
+         << setw(12) << "Gain" << "vs single" << endl;
+    cout << string(86, '-') << endl;
+    
+    for(int tableSize : tableSizes){
+        vector<string> urls = makeURLs(tableSize / 2, rng);
+        
+        //Lookups: every query is a hit, in random order
+        URLHashTable* table = makeTable(tableSize);
+        for(const string& url : urls){
+            table->insert(url);
+        }
+        vector<string> queries;
+        queries.reserve(queryCount);
+        for(int i = 0; i < queryCount; i++){
+            queries.push_back(urls[rng() % urls.size()]);
+        }
+        
+        vector<double> seconds, noPrefetch;
+        timeSearch(*table, queries, 0, sink);
+        for(int batchSize : batchSizes){
+            table->setPrefetch(true);
+            seconds.push_back(timeSearch(*table, queries, batchSize, sink));
+            table->setPrefetch(false);
+            noPrefetch.push_back(batchSize == 0 ? seconds.back() : timeSearch(*table, queries, batchSize, sink));
+        }
+        addResults(results, tableSize, "search", batchSizes, seconds, noPrefetch, queryCount);
+        delete table;
+        
+        //Inserts: the same URLs into an empty table of the same size
+        shuffle(urls.begin(), urls.end(), rng);
+        seconds.clear();
+        noPrefetch.clear();
+        for(int batchSize : batchSizes){
+            seconds.push_back(timeInsert(tableSize, urls, batchSize, true, sink));
+            noPrefetch.push_back(batchSize == 0 ? seconds.back() : timeInsert(tableSize, urls, batchSize, false, sink));
+        }
+        addResults(results, tableSize, "insert", batchSizes, seconds, noPrefetch, urls.size());
+        cout << endl;
+    }
+    
+    cout << "(checksum " << sink << ")" << endl;
+    writeCSV(results, "batch_lookup.csv");
+    
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Concurrent Insert Benchmark
+// A crawler-style dedup stream (every URL appears twice, in random order)
+// is split over 1 to N producer threads (N = hardware threads, or the first
+// argument) that insert into one shared table. The lock-free table is
+// compared with the lock-per-shard table; both are sized so the stream
+// fills them to 40%. A lookup pass over the same URLs follows.
+// Results go to concurrent_insert.csv
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include "include/ConcurrentURLHashTable.h"
+#include "include/ShardedURLHashTable.h"
+
+using namespace std;
+
+struct ConcurrentResult {
+    string table;
+    int threads;
+    double insertMops;
+    double searchMops;
+    int stored;  // Distinct URLs the table ended up with
+};
+
+//Distinct URLs of 30-60 bytes spread over a few thousand hosts
+vector<string> makeURLs(int count, mt19937& rng) {
+    const string chars = "abcdefghijklmnopqrstuvwxyz0123456789-_./";
+    vector<string> urls;
+    urls.reserve(count);
+
+    for(int i = 0; i < count; i++){
+        string url = "http://www.site" + to_string(rng() % 5000) + ".com/" + to_string(i) + "/";
+        int length = 30 + rng() % 31;
+        while((int)url.size() < length){
+            url.push_back(chars[rng() % chars.size()]);
+        }
+        urls.push_back(url);
+    }
+    return urls;
+}
+
+//Runs op(url) over stream with thread t taking every threads-th URL, and
+//returns the elapsed seconds
+template <typename Op>
+double runThreads(const vector<string>& stream, int threads, Op op) {
+    vector<thread> workers;
+
+    auto start = chrono::steady_clock::now();
+    for(int t = 0; t < threads; t++){
+        workers.push_back(thread([&stream, threads, t, &op]() {
+            for(size_t i = t; i < stream.size(); i += threads){
+                op(stream[i]);
+            }
+        }));
+    }
+    for(thread& worker : workers){
+        worker.join();
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+template <typename Table>
+ConcurrentResult measure(const string& name, Table& table, const vector<string>& stream, int threads) {
+    atomic<long> hits(0);
+
+    double insertSeconds = runThreads(stream, threads, [&table](const string& url) {
+        table.insert(url);
+    });
+    double searchSeconds = runThreads(stream, threads, [&table, &hits](const string& url) {
+        if(table.search(url).success){
+            hits.fetch_add(1, memory_order_relaxed);
+        }
+    });
+
+    if(hits != (long)stream.size()){
+        cerr << name << ": " << stream.size() - hits << " stored URLs not found" << endl;
+    }
+
+    ConcurrentResult result;
+    result.table = name;
+    result.threads = threads;
+    result.insertMops = stream.size() / insertSeconds / 1e6;
+    result.searchMops = stream.size() / searchSeconds / 1e6;
+    result.stored = table.getNumElements();
+    return result;
+}
+
+void writeCSV(const vector<ConcurrentResult>& results, const string& filename) {
+    ofstream file(filename);
+    file << "Table,Threads,InsertMopsPerSec,SearchMopsPerSec,Stored\n";
+    for(const ConcurrentResult& r : results){
+        file << r.table << "," << r.threads << "," << fixed << setprecision(4)
+             << r.insertMops << "," << r.searchMops << "," << r.stored << "\n";
+    }
+    file.close();
+    cout << "Output file created: " << filename << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+    if(maxThreads < 1) maxThreads = 1;
+
+    const int distinct = 1 << 20;
+    const int tableSize = (int)(distinct / 0.4);
+    const int shards = 64;
+
+    vector<int> threadCounts;
+    for(int t = 1; t < maxThreads; t *= 2){
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    mt19937 rng(12345);
+    vector<string> urls = makeURLs(distinct, rng);
+    vector<string> stream(urls);
+    stream.insert(stream.end(), urls.begin(), urls.end());
+    shuffle(stream.begin(), stream.end(), rng);
+
+    cout << "Concurrent Insert Benchmark" << endl;
+    cout << "(" << stream.size() << " inserts of " << distinct << " distinct URLs, wyhash, up to "
+         << maxThreads << " threads)" << endl << endl;
+    cout << left << setw(20) << "Table" << setw(10) << "Threads" << setw(14) << "Insert Mops/s"
+         << setw(14) << "Search Mops/s" << "Stored" << endl;
+    cout << string(66, '-') << endl;
+
+    vector<ConcurrentResult> results;
+    for(int threads : threadCounts){
+        ConcurrentURLHashTable lockFree(tableSize);
+        lockFree.setHashFunction(WYHASH_HASH);
+        results.push_back(measure("LockFree", lockFree, stream, threads));
+
+        ShardedURLHashTable sharded(tableSize, shards);
+        sharded.setHashFunction(WYHASH_HASH);
+        results.push_back(measure("Sharded" + to_string(shards), sharded, stream, threads));
+
+        for(size_t i = results.size() - 2; i < results.size(); i++){
+            const ConcurrentResult& r = results[i];
+            cout << left << setw(20) << r.table << setw(10) << r.threads
+                 << setw(14) << fixed << setprecision(2) << r.insertMops
+                 << setw(14) << r.searchMops << r.stored << endl;
+        }
+    }
+    cout << endl;
+
+    writeCSV(results, "concurrent_insert.csv");
+
+    return 0;
+}
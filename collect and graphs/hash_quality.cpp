@@ -0,0 +1,227 @@
+// Hash Quality Analyzer
+// Scores how evenly each hash spreads a URL corpus over tables of several
+// sizes, primes and powers of two alike (HashQuality.h):
+//   - chi-squared of bucket occupancy against uniform, as a z-score
+//   - avalanche: how many slot bits one flipped input bit changes, the worst
+//     input/output bit pair and the worst output bit correlation, all
+//     against a random function of the same table size
+//   - probes per search hit and miss under linear and quadratic probing,
+//     observed against the uniform hashing estimates at the same load
+// polynomialHash and universalHash reduce by the table size while hashing,
+// so they are analyzed in that sized form as well as in their hash64 form.
+// Work is split across threads. Results go to hash_quality.csv
+//
+// Usage: hash_quality [file] [--keys N] [--seed S] [--sizes m1,m2,...]
+//                     [--load LF] [--avalanche N] [--hash NAME] [-j threads]
+// Without a file the corpus is URLWorkload's synthetic one (default 200000
+// keys). Default sizes: the largest power of two that holds half the corpus
+// at the probe load, half and a quarter of it, and the prime below each
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "include/HashQuality.h"
+#include "include/HashRegistry.h"
+#include "include/MappedURLFile.h"
+#include "include/URLWorkload.h"
+
+using namespace std;
+
+bool parseSizes(const char* text, vector<int>& sizes) {
+    sizes.clear();
+    while(*text){
+        char* end;
+        long size = strtol(text, &end, 10);
+        if(end == text || size < 2 || size > (1L << 30)){
+            return false;
+        }
+        sizes.push_back((int)size);
+        text = *end == ',' ? end + 1 : end;
+    }
+    return !sizes.empty();
+}
+
+vector<int> defaultSizes(long long keys, double load) {
+    long long largest = 4;
+    while(largest * 2 * load <= keys / 2 && largest < (1 << 30)){
+        largest *= 2;
+    }
+    vector<int> sizes;
+    for(long long size = largest / 4; size <= largest; size *= 2){
+        sizes.push_back(HashQualityAnalyzer::previousPrime((int)size));
+        sizes.push_back((int)size);
+    }
+    return sizes;
+}
+
+void printReport(const QualityReport& r) {
+    string label = string(r.target.algorithm->shortName) + " (" + HashQualityAnalyzer::formName(r.target) + ")";
+    cout << left << setw(22) << label << right << fixed
+         << setprecision(1) << setw(9) << r.distribution.zScore
+         << setw(6) << r.distribution.maxBucket
+         << setprecision(3) << setw(9) << r.avalanche.changedRatio
+         << setw(8) << r.avalanche.worstBias << setw(4) << r.avalanche.worstByte
+         << setw(8) << r.avalanche.worstBIC
+         << setprecision(2) << setw(7) << r.linear.observedHit << "/" << left << setw(5) << r.linear.expectedHit
+         << right << setw(7) << r.linear.observedMiss << "/" << left << setw(5) << r.linear.expectedMiss
+         << right << setw(7) << r.quadratic.observedHit << "/" << left << setw(5) << r.quadratic.expectedHit
+         << right << setw(7) << r.quadratic.observedMiss << "/" << left << setw(5) << r.quadratic.expectedMiss
+         << right;
+    if(r.quadratic.failed > 0){
+        cout << "  " << r.quadratic.failed << " quadratic inserts failed";
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string filename;
+    long long numKeys = 200000;
+    unsigned long long seed = 42;
+    vector<int> sizes;
+    double load = 0.5;
+    int avalancheKeys = 1000;
+    string hashName;
+    int threads = thread::hardware_concurrency();
+    bool usage = false;
+    
+    for(int i = 1; i < argc && !usage; i++){
+        bool hasValue = i + 1 < argc;
+        if(strcmp(argv[i], "--keys") == 0 && hasValue){
+            numKeys = atoll(argv[++i]);
+            usage = numKeys < 4;
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && hasValue){
+            seed = strtoull(argv[++i], 0, 10);
+        }
+        else if(strcmp(argv[i], "--sizes") == 0 && hasValue){
+            usage = !parseSizes(argv[++i], sizes);
+        }
+        else if(strcmp(argv[i], "--load") == 0 && hasValue){
+            load = atof(argv[++i]);
+            usage = load <= 0 || load >= 1;
+        }
+        else if(strcmp(argv[i], "--avalanche") == 0 && hasValue){
+            avalancheKeys = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--hash") == 0 && hasValue){
+            hashName = argv[++i];
+        }
+        else if(strcmp(argv[i], "-j") == 0 && hasValue){
+            threads = atoi(argv[++i]);
+        }
+        else if(argv[i][0] != '-' && filename.empty()){
+            filename = argv[i];
+        }
+        else{
+            usage = true;
+        }
+    }
+    
+    vector<QualityTarget> targets;
+    for(const QualityTarget& target : HashQualityAnalyzer::allTargets()){
+        if(hashName.empty() || hashName == target.algorithm->shortName){
+            targets.push_back(target);
+        }
+    }
+    if(usage || targets.empty()){
+        cout << "Usage: " << argv[0] << " [file] [--keys N] [--seed S] [--sizes m1,m2,...] [--load LF]" << endl
+             << "       [--avalanche N] [--hash NAME] [-j threads]" << endl;
+        cout << "Hash names:";
+        for(const QualityTarget& target : HashQualityAnalyzer::allTargets()){
+            if(!target.sized) cout << " " << target.algorithm->shortName;
+        }
+        cout << endl;
+        return 1;
+    }
+    if(threads < 1) threads = 1;
+    
+    vector<string> keys;
+    if(!filename.empty()){
+        MappedURLFile urlFile;
+        if(!urlFile.open(filename, threads)){
+            cout << "Error opening file: " << filename << endl;
+            return 1;
+        }
+        for(const URLView& url : urlFile.getURLs()){
+            keys.push_back(url.str());
+        }
+        cout << "Corpus: " << keys.size() << " URLs from " << filename << endl;
+    }
+    else{
+        URLCorpus corpus(numKeys, seed);
+        keys.resize(numKeys);
+        for(long long i = 0; i < numKeys; i++){
+            corpus.url(i, false, keys[i]);
+        }
+        cout << "Corpus: " << numKeys << " synthetic URLs (seed " << seed << ")" << endl;
+    }
+    if(keys.size() < 4){
+        cout << "Corpus too small to analyze." << endl;
+        return 1;
+    }
+    if(sizes.empty()){
+        sizes = defaultSizes(keys.size(), load);
+    }
+    cout << "Probe simulation at load factor " << load << " (at most half the corpus inserted), "
+         << threads << " threads" << endl;
+    
+    HashQualityAnalyzer analyzer(keys, threads);
+    analyzer.setLoadFactor(load);
+    analyzer.setAvalancheKeys(avalancheKeys);
+    
+    ofstream csvFile("hash_quality.csv");
+    csvFile << "HashFunction,Form,TableSize,SizeKind,Keys,ChiSquared,ChiZ,MaxBucket,EmptyFraction,ExpectedEmpty,"
+            << "AvalancheFlips,AvalancheRatio,WorstBias,WorstBiasByteFromEnd,WorstBIC,ProbeLoad,"
+            << "LinearHitObserved,LinearHitExpected,LinearMissObserved,LinearMissExpected,LinearMaxProbes,"
+            << "QuadraticHitObserved,QuadraticHitExpected,QuadraticMissObserved,QuadraticMissExpected,"
+            << "QuadraticMaxProbes,QuadraticFailed\n";
+    
+    auto start = chrono::steady_clock::now();
+    for(int size : sizes){
+        const char* kind = SlotReducer::isPowerOfTwo(size) ? "power of two"
+                         : HashQualityAnalyzer::isPrime(size) ? "prime" : "composite";
+        cout << "\nTable size " << size << " (" << kind << ")" << endl;
+        cout << left << setw(22) << "Hash" << right << setw(9) << "Chi2 z" << setw(6) << "Max"
+             << setw(9) << "Aval." << setw(8) << "Bias" << setw(4) << "@" << setw(8) << "BIC"
+             << setw(13) << "Lin hit" << setw(13) << "Lin miss" << setw(13) << "Quad hit"
+             << setw(13) << "Quad miss" << endl;
+        
+        for(const QualityTarget& target : targets){
+            QualityReport r = analyzer.analyze(target, size);
+            printReport(r);
+            
+            csvFile << r.target.algorithm->shortName << "," << HashQualityAnalyzer::formName(r.target) << ","
+                    << size << "," << kind << "," << r.keys << "," << fixed << setprecision(2)
+                    << r.distribution.chiSquared << "," << r.distribution.zScore << ","
+                    << r.distribution.maxBucket << "," << setprecision(5)
+                    << r.distribution.emptyFraction << "," << r.distribution.expectedEmpty << ","
+                    << r.avalanche.flips << "," << r.avalanche.changedRatio << ","
+                    << r.avalanche.worstBias << "," << r.avalanche.worstByte << ","
+                    << r.avalanche.worstBIC << "," << r.linear.load << ","
+                    << r.linear.observedHit << "," << r.linear.expectedHit << ","
+                    << r.linear.observedMiss << "," << r.linear.expectedMiss << ","
+                    << r.linear.maxProbes << ","
+                    << r.quadratic.observedHit << "," << r.quadratic.expectedHit << ","
+                    << r.quadratic.observedMiss << "," << r.quadratic.expectedMiss << ","
+                    << r.quadratic.maxProbes << "," << r.quadratic.failed << "\n";
+        }
+    }
+    csvFile.close();
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "\nChi2 z: |z| above about 3 is less uniform than chance. Aval.: slot bits changed per input" << endl
+         << "bit flip relative to a random function (1.000 ideal). Bias: worst input/output bit pair," << endl
+         << "@ its byte counted from the key's end. BIC: worst output bit pair correlation. Probes:" << endl
+         << "observed/expected average slots examined." << endl;
+    cout << "\nAnalysis took " << setprecision(1) << seconds << " s" << endl;
+    cout << "Output file created: hash_quality.csv" << endl;
+    
+    return 0;
+}
@@ -0,0 +1,346 @@
+// Hash Throughput Benchmark
+// Measures GB/s of every hash function across URL lengths: the original
+// byte loops and the wide variants under each kernel this CPU supports.
+// Results go to hash_throughput.csv. A second pass times every registry
+// hash on the real URL corpus (test1.txt) against the bitwise hash and
+// writes hash_corpus_throughput.csv; a third times each slot reduction
+// against a hardware % (slot_reduction.csv)
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include "include/HashFunctions.h"
+#include "include/HashRegistry.h"
+#include "include/FastHashes.h"
+#include "include/MappedURLFile.h"
+#include "include/SlotReducer.h"
+
+using namespace std;
+
+struct ThroughputResult {
+    string hashFunction;
+    string kernel;
+    int urlLength;
+    double gbPerSec;
+    double nsPerHash;
+    double speedup;  // Over the byte loop of the same hash and length
+};
+
+struct CorpusResult {
+    string hashFunction;
+    string implementation;
+    double gbPerSec;
+    double nsPerHash;
+    double vsBitwise;  // Speed relative to the bitwise hash
+};
+
+typedef unsigned long (HashFunctions::*HashMethod)(const string&, int);
+
+struct HashUnderTest {
+    string name;
+    HashMethod byteLoop;
+    HashMethod wide;
+};
+
+//URLs of exactly length bytes: a shared scheme and host followed by
+//random path characters, as in the crawl data
+vector<string> makeURLs(int length, int count, mt19937& rng) {
+    const string prefix = "http://www.example.com/";
+    const string chars = "abcdefghijklmnopqrstuvwxyz0123456789-_./";
+    vector<string> urls;
+    
+    for(int i = 0; i < count; i++){
+        string url = prefix.substr(0, length < (int)prefix.size() ? length : prefix.size());
+        while((int)url.size() < length){
+            url.push_back(chars[rng() % chars.size()]);
+        }
+        urls.push_back(url);
+    }
+    return urls;
+}
+
+//URLs of a test file, copied out of the mapped file
+vector<string> loadURLsFromFile(const string& filename) {
+    vector<string> urls;
+    MappedURLFile urlFile;
+    
+    if(!urlFile.open(filename, 1)){
+        return urls;
+    }
+    for(const URLView& url : urlFile.getURLs()){
+        urls.push_back(url.str());
+    }
+    return urls;
+}
+
+//Hashes every URL `rounds` times and returns the elapsed seconds. The
+//results are folded into sink so the calls cannot be optimized away
+double timeHash(HashFunctions& f, HashMethod method, const vector<string>& urls, int size, int rounds, unsigned long& sink) {
+    auto start = chrono::steady_clock::now();
+    for(int r = 0; r < rounds; r++){
+        for(const string& url : urls){
+            sink += (f.*method)(url, size);
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+//Registry hashes go through the same function pointer the Swiss engine
+//uses, then to a slot the way the open addressing tables do
+double timeAlgorithm(HashFunctions& f, const HashAlgorithm& algo, const vector<string>& urls, const SlotReducer& slots, int rounds, unsigned long& sink) {
+    auto start = chrono::steady_clock::now();
+    for(int r = 0; r < rounds; r++){
+        for(const string& url : urls){
+            sink += slots.reduce(algo.hash64(f, url.data(), url.length()));
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+CorpusResult measureCorpus(HashFunctions& f, const HashAlgorithm& algo, const vector<string>& urls,
+                           double corpusBytes, const SlotReducer& slots, unsigned long& sink) {
+    const double targetBytes = 64.0 * 1024 * 1024;
+    int rounds = (int)(targetBytes / corpusBytes);
+    if(rounds < 1) rounds = 1;
+    
+    timeAlgorithm(f, algo, urls, slots, 1, sink);
+    double seconds = timeAlgorithm(f, algo, urls, slots, rounds, sink);
+    double hashes = (double)rounds * urls.size();
+    
+    CorpusResult result;
+    result.hashFunction = algo.name;
+    result.implementation = algo.implementation ? algo.implementation() : "-";
+    result.gbPerSec = corpusBytes * rounds / seconds / 1e9;
+    result.nsPerHash = seconds * 1e9 / hashes;
+    result.vsBitwise = 1.0;
+    return result;
+}
+
+//Nanoseconds per reduction along a dependent chain (each index feeds the
+//next hash), which is how a lookup sees it. reduction -1 is a plain %
+double timeReduction(const vector<unsigned long long>& hashes, int size, int reduction, int rounds, unsigned long& sink) {
+    SlotReducer slots(size, reduction < 0 ? REDUCE_MOD : (ReductionMethod)reduction);
+    volatile int divisorSource = size;  //Keeps % a real divide
+    unsigned long long divisor = divisorSource;
+    unsigned long long idx = 0;
+    
+    auto start = chrono::steady_clock::now();
+    for(int r = 0; r < rounds; r++){
+        for(unsigned long long h : hashes){
+            if(reduction < 0){
+                idx = (h ^ idx) % divisor;
+            }
+            else{
+                idx = slots.reduce(h ^ idx);
+            }
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    sink += idx;
+    return chrono::duration<double>(end - start).count() * 1e9 / ((double)rounds * hashes.size());
+}
+
+ThroughputResult measure(HashFunctions& f, const string& hashName, const string& kernelName, HashMethod method,
+                         const vector<string>& urls, int length, int size, unsigned long& sink) {
+    //Roughly 64 MB hashed per measurement, after one warm-up pass
+    const double targetBytes = 64.0 * 1024 * 1024;
+    int rounds = (int)(targetBytes / ((double)urls.size() * length));
+    if(rounds < 1) rounds = 1;
+    
+    timeHash(f, method, urls, size, 1, sink);
+    double seconds = timeHash(f, method, urls, size, rounds, sink);
+    double hashes = (double)rounds * urls.size();
+    
+    ThroughputResult result;
+    result.hashFunction = hashName;
+    result.kernel = kernelName;
+    result.urlLength = length;
+    result.gbPerSec = (hashes * length) / seconds / 1e9;
+    result.nsPerHash = seconds * 1e9 / hashes;
+    result.speedup = 1.0;
+    return result;
+}
+
+int main(){
+    const int tableSize = 2039;  // Prime; keeps k*size within the wide kernels' range
+    const int urlsPerLength = 4096;
+    int lengths[] = {8, 16, 24, 32, 48, 64, 128, 256, 512, 1024};
+    
+    HashUnderTest hashes[] = {
+        {"Bitwise", &HashFunctions::bitwiseHash, &HashFunctions::bitwiseWideHash},
+        {"Polynomial", &HashFunctions::polynomialHash, &HashFunctions::polynomialWideHash},
+        {"Universal", &HashFunctions::universalHash, &HashFunctions::universalWideHash}
+    };
+    
+    vector<HashKernel> kernels;
+    HashKernel allKernels[] = {KERNEL_SCALAR, KERNEL_SSE41, KERNEL_AVX2};
+    for(HashKernel kernel : allKernels){
+        if(HashFunctions::kernelSupported(kernel)){
+            kernels.push_back(kernel);
+        }
+    }
+    HashKernel defaultKernel = HashFunctions::getKernel();
+    
+    cout << "Hash throughput benchmark (table size " << tableSize << ", "
+         << urlsPerLength << " URLs per length)" << endl;
+    cout << "Wide kernels available:";
+    for(HashKernel kernel : kernels){
+        cout << " " << HashFunctions::kernelName(kernel);
+    }
+    cout << "\n" << endl;
+    
+    HashFunctions f;
+    mt19937 rng(12345);
+    unsigned long sink = 0;
+    vector<ThroughputResult> allResults;
+    
+    cout << left << setw(12) << "Hash" << setw(12) << "Kernel" << setw(8) << "Length"
+         << setw(12) << "GB/s" << setw(12) << "ns/hash" << setw(10) << "Speedup" << endl;
+    cout << string(66, '-') << endl;
+    
+    for(int length : lengths){
+        vector<string> urls = makeURLs(length, urlsPerLength, rng);
+        
+        for(const HashUnderTest& h : hashes){
+            //The wide variants must agree with the byte loop on every key
+            for(const string& url : urls){
+                if((f.*h.byteLoop)(url, tableSize) != (f.*h.wide)(url, tableSize)){
+                    cout << "Mismatch in " << h.name << " wide hash for: " << url << endl;
+                    return 1;
+                }
+            }
+            
+            ThroughputResult base = measure(f, h.name, "Byte loop", h.byteLoop, urls, length, tableSize, sink);
+            allResults.push_back(base);
+            
+            for(HashKernel kernel : kernels){
+                HashFunctions::setKernel(kernel);
+                ThroughputResult result = measure(f, h.name, HashFunctions::kernelName(kernel), h.wide,
+                                                  urls, length, tableSize, sink);
+                result.speedup = result.gbPerSec / base.gbPerSec;
+                allResults.push_back(result);
+            }
+            HashFunctions::setKernel(defaultKernel);
+        }
+    }
+    
+    for(const auto& result : allResults){
+        cout << left << setw(12) << result.hashFunction
+             << setw(12) << result.kernel
+             << setw(8) << result.urlLength
+             << fixed << setprecision(3) << setw(12) << result.gbPerSec
+             << setprecision(2) << setw(12) << result.nsPerHash
+             << setprecision(2) << result.speedup << "x" << endl;
+    }
+    
+    // Export to CSV
+    ofstream csvFile("hash_throughput.csv");
+    csvFile << "HashFunction,Kernel,URLLength,GBPerSec,NsPerHash,Speedup\n";
+    for(const auto& result : allResults){
+        csvFile << result.hashFunction << ","
+                << result.kernel << ","
+                << result.urlLength << ","
+                << fixed << setprecision(6) << result.gbPerSec << ","
+                << result.nsPerHash << ","
+                << result.speedup << "\n";
+    }
+    csvFile.close();
+    
+    //Registry hashes on the real corpus
+    vector<string> corpus = loadURLsFromFile("test1.txt");
+    vector<CorpusResult> corpusResults;
+    
+    if(corpus.empty()){
+        cout << "\ntest1.txt not found; skipping the corpus comparison" << endl;
+    }
+    else{
+        double corpusBytes = 0;
+        for(const string& url : corpus){
+            corpusBytes += url.length();
+        }
+        
+        cout << "\nRegistry hashes on test1.txt (" << corpus.size() << " URLs, average "
+             << fixed << setprecision(1) << corpusBytes / corpus.size() << " bytes)" << endl;
+        cout << left << setw(40) << "Hash" << setw(12) << "Path" << setw(12) << "GB/s"
+             << setw(12) << "ns/hash" << setw(10) << "vs Bitwise" << endl;
+        cout << string(86, '-') << endl;
+        
+        SlotReducer slots(tableSize, REDUCE_MOD);
+        double bitwiseRate = 0;
+        for(int i = 0; i < HashRegistry::count(); i++){
+            const HashAlgorithm& algo = HashRegistry::get(i);
+            CorpusResult result = measureCorpus(f, algo, corpus, corpusBytes, slots, sink);
+            if(algo.type == BITWISE_HASH){
+                bitwiseRate = result.gbPerSec;
+            }
+            corpusResults.push_back(result);
+            
+            //Also time the CRC32C table fallback when the instruction is in use
+            if(algo.type == CRC32C_HASH && FastHashes::crc32cHardwareEnabled()){
+                FastHashes::setCrc32cHardware(false);
+                corpusResults.push_back(measureCorpus(f, algo, corpus, corpusBytes, slots, sink));
+                FastHashes::setCrc32cHardware(true);
+            }
+        }
+        
+        ofstream corpusFile("hash_corpus_throughput.csv");
+        corpusFile << "HashFunction,Implementation,GBPerSec,NsPerHash,VsBitwise\n";
+        for(auto& result : corpusResults){
+            result.vsBitwise = result.gbPerSec / bitwiseRate;
+            cout << left << setw(40) << result.hashFunction
+                 << setw(12) << result.implementation
+                 << fixed << setprecision(3) << setw(12) << result.gbPerSec
+                 << setprecision(2) << setw(12) << result.nsPerHash
+                 << setprecision(2) << result.vsBitwise << "x" << endl;
+            corpusFile << result.hashFunction << ","
+                       << result.implementation << ","
+                       << fixed << setprecision(6) << result.gbPerSec << ","
+                       << result.nsPerHash << ","
+                       << result.vsBitwise << "\n";
+        }
+        corpusFile.close();
+    }
+    
+    //Slot reduction latency: prime and power-of-two sizes
+    vector<unsigned long long> hashValues(1 << 16);
+    for(unsigned long long& h : hashValues){
+        h = ((unsigned long long)rng() << 32) | rng();
+    }
+    int reductionSizes[] = {2039, 1048573, 1 << 20};
+    const char* reductionNames[] = {"% (divide)", "Exact remainder", "Fastrange", "Power-of-two mask"};
+    
+    cout << "\nSlot reduction (ns per hash along a dependent chain)" << endl;
+    cout << left << setw(12) << "Size" << setw(20) << "Method" << setw(10) << "ns" << endl;
+    cout << string(42, '-') << endl;
+    
+    ofstream reductionFile("slot_reduction.csv");
+    reductionFile << "TableSize,Method,NsPerReduction\n";
+    for(int size : reductionSizes){
+        for(int method = -1; method <= REDUCE_POW2; method++){
+            //A mask only works on power-of-two sizes
+            if(method == REDUCE_POW2 && !SlotReducer::isPowerOfTwo(size)){
+                continue;
+            }
+            double ns = timeReduction(hashValues, size, method, 200, sink);
+            cout << left << setw(12) << size << setw(20) << reductionNames[method + 1]
+                 << fixed << setprecision(2) << ns << endl;
+            reductionFile << size << "," << reductionNames[method + 1] << "," << fixed << setprecision(4) << ns << "\n";
+        }
+    }
+    reductionFile.close();
+    
+    cout << "\n(checksum " << sink << ")" << endl;
+    cout << "Output file created: hash_throughput.csv" << endl;
+    if(!corpusResults.empty()){
+        cout << "Output file created: hash_corpus_throughput.csv" << endl;
+    }
+    cout << "Output file created: slot_reduction.csv" << endl;
+    
+    return 0;
+}
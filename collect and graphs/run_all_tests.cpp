@@ -1,13 +1,41 @@
 // Automated Test Runner for Report Data Collection
-// Runs all 6 configurations and exports results to CSV
+// Runs all 43 configurations and exports results to CSV. After the insert
+// pass behind test_results.csv, every run searches all stored URLs and as
+// many absent ones, then deletes every URL; test_percentiles.csv holds the
+// probe and latency percentiles of each operation type
+//
+// Usage: run_all_tests [-j workers] [--pin] [--serial-timing]
+//                      [--timer steady|tsc] [--sample N]
+//   -j N             Run N configuration/size jobs at once (default 1)
+//   --pin            Pin worker i to CPU i (Linux and Windows)
+//   --serial-timing  Let only one timed insert pass run at a time; table
+//                    setup and teardown still overlap
+//   --timer          Clock behind AvgTime (default steady_clock)
+//   --sample N       Time every Nth insert only (default 1, every insert)
+// Results are stored by job index, so the output files list the runs in the
+// same order whatever the number of workers
 
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
 #include <iomanip>
 #include <vector>
-#include "include/URLHashTable.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#endif
+#include "include/BasicURLHashTable.h"
+#include "include/SwissHashTable.h"
+#include "include/CuckooHashTable.h"
+#include "include/MappedURLFile.h"
 
 using namespace std;
 
@@ -17,72 +45,144 @@ struct TestResult {
     double avgComparisons;
     int maxComparisons;
     double avgTime;
-    int numQueries;
+    long long numQueries;
     string hashFunction;
     string probingMethod;
+    Statistics stats;  // All phases, for the percentile export
 };
 
-bool isValidURL(const string& url) {
-    if(url.length() < 6) return false;
-    if(url.length() >= 7 && url.substr(0, 7) == "http://") return true;
-    if(url.length() >= 6 && url.substr(0, 6) == "http//") return true;
-    if(url.length() >= 8 && url.substr(0, 8) == "https://") return true;
-    if(url.length() >= 7 && url.substr(0, 7) == "https//") return true;
-    return false;
-}
-
+//Copies the URLs out of the mapped file: the corpus is reused by every job
 vector<string> loadURLsFromFile(const string& filename, int& tableSize) {
     vector<string> urls;
-    ifstream inputFile(filename);
+    MappedURLFile urlFile;
     
-    if(!inputFile.is_open()){
+    if(!urlFile.open(filename, (int)thread::hardware_concurrency())){
         cout << "Error opening file: " << filename << endl;
         return urls;
     }
     
-    string line;
-    if(getline(inputFile, line)){
-        stringstream ss(line);
-        ss >> tableSize;
+    tableSize = urlFile.getTableSize();
+    urls.reserve(urlFile.getURLs().size());
+    for(const URLView& url : urlFile.getURLs()){
+        urls.push_back(url.str());
     }
+    return urls;
+}
+
+//Timed sections and untimed work (building and freeing tables) exclude each
+//other: a timed pass running beside other jobs measures contended caches
+//and memory bandwidth, and time spent descheduled once workers outnumber
+//cores. Waiting timed sections go first so untimed work cannot starve
+//them. Does nothing unless serialize
+class TimingGate {
+private:
+    mutex lock;
+    condition_variable changed;
+    bool serialize;
+    bool timing;   // A timed section is running
+    int waiting;   // Workers queued for a timed section
+    int untimed;   // Workers in untimed sections
+
+public:
+    TimingGate(bool serializeTiming) : serialize(serializeTiming), timing(false), waiting(0), untimed(0) {}
     
-    while(getline(inputFile, line)){
-        stringstream ss(line);
-        string url;
-        
-        while(getline(ss, url, ',')){
-            size_t start = url.find_first_not_of(" \t\r\n");
-            size_t end = url.find_last_not_of(" \t\r\n");
-            
-            if(start != string::npos && end != string::npos){
-                url = url.substr(start, end - start + 1);
-            }
-            
-            if(!url.empty() && isValidURL(url)){
-                urls.push_back(url);
-            }
-        }
+    void beginTimed(){
+        if(!serialize) return;
+        unique_lock<mutex> guard(lock);
+        waiting++;
+        changed.wait(guard, [this]() { return !timing && untimed == 0; });
+        waiting--;
+        timing = true;
     }
     
-    inputFile.close();
-    return urls;
+    void endTimed(){
+        if(!serialize) return;
+        lock_guard<mutex> guard(lock);
+        timing = false;
+        changed.notify_all();
+    }
+    
+    void beginUntimed(){
+        if(!serialize) return;
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [this]() { return !timing && waiting == 0; });
+        untimed++;
+    }
+    
+    void endUntimed(){
+        if(!serialize) return;
+        lock_guard<mutex> guard(lock);
+        untimed--;
+        changed.notify_all();
+    }
+};
+
+//Binds a worker to one CPU so its caches and clock stay put between jobs
+bool pinThread(thread& worker, int cpu) {
+#if defined(_WIN32)
+    return SetThreadAffinityMask(worker.native_handle(), (DWORD_PTR)1 << (cpu % 64)) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(worker.native_handle(), sizeof(cpus), &cpus) == 0;
+#else
+    (void)worker;
+    (void)cpu;
+    return false;
+#endif
 }
 
-TestResult runTest(int size, const vector<string>& urls, HashType hashType, ProbingMethod probingType, 
-                   const string& hashName, const string& probeName) {
-    URLHashTable* hashTable = new URLHashTable(size);
+//Table engines under test share the same hash/stats interface. The open
+//addressing tables are used through their compile-time specializations so
+//the timings measure the algorithms rather than configuration dispatch
+template <typename HashPolicy, typename ProbePolicy>
+BasicURLHashTable<HashPolicy, ProbePolicy>* makeTable(BasicURLHashTable<HashPolicy, ProbePolicy>*, int size, HashType, ProbingMethod) {
+    return new BasicURLHashTable<HashPolicy, ProbePolicy>(size);
+}
+
+SwissHashTable* makeTable(SwissHashTable*, int size, HashType hashType, ProbingMethod) {
+    SwissHashTable* hashTable = new SwissHashTable(size);
     hashTable->setHashFunction(hashType);
-    hashTable->setProbingMethod(probingType);
+    return hashTable;
+}
+
+CuckooHashTable* makeTable(CuckooHashTable*, int size, HashType hashType, ProbingMethod) {
+    CuckooHashTable* hashTable = new CuckooHashTable(size);
+    hashTable->setHashFunction(hashType);
+    return hashTable;
+}
+
+//Clock and sampling applied to every table under test
+struct TimerSettings {
+    TimerSource source;
+    int sampleEvery;
+};
+
+//The insert pass fills the summary columns; the search and delete passes
+//only feed the percentiles. The table is built and freed outside the timed
+//passes
+template <typename Table>
+TestResult runTest(int size, const vector<string>& urls, const vector<string>& absent, HashType hashType, ProbingMethod probingType, 
+                   const string& hashName, const string& probeName, const TimerSettings& timing, TimingGate& gate) {
+    gate.beginUntimed();
+    Table* hashTable = makeTable((Table*)0, size, hashType, probingType);
+    hashTable->setTimerSource(timing.source);
+    hashTable->setSampleInterval(timing.sampleEvery);
+    gate.endUntimed();
     
+    gate.beginTimed();
     int counter = 0;
     for(const string& url : urls){
         if(hashTable->insertURL(url)){
             counter++;
         }
     }
+    gate.endTimed();
     
+    gate.beginUntimed();
     TestResult result;
-    result.tableSize = size;
+    result.tableSize = hashTable->getSize();
     result.loadFactor = hashTable->getLoadFactor();
     result.avgComparisons = hashTable->getStats().getAvgComparisons();
     result.maxComparisons = hashTable->getStats().getMaxComp();
@@ -90,14 +190,69 @@ TestResult runTest(int size, const vector<string>& urls, HashType hashType, Prob
     result.numQueries = hashTable->getStats().getNumQueries();
     result.hashFunction = hashName;
     result.probingMethod = probeName;
+    gate.endUntimed();
     
+    gate.beginTimed();
+    for(const string& url : urls){
+        hashTable->searchURL(url);
+    }
+    for(const string& url : absent){
+        hashTable->searchURL(url);
+    }
+    for(const string& url : urls){
+        hashTable->deleteURL(url);
+    }
+    gate.endTimed();
+    
+    gate.beginUntimed();
+    result.stats = hashTable->getStats();
     delete hashTable;
+    gate.endUntimed();
     return result;
 }
 
-int main(){
+int main(int argc, char* argv[]){
     string filename = "test1.txt";
     int originalSize = 0;
+    int numWorkers = 1;
+    bool pin = false;
+    bool serialTiming = false;
+    TimerSettings timing;
+    timing.source = TIMER_STEADY;
+    timing.sampleEvery = 1;
+    
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "-j") == 0 && i + 1 < argc){
+            numWorkers = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--pin") == 0){
+            pin = true;
+        }
+        else if(strcmp(argv[i], "--serial-timing") == 0){
+            serialTiming = true;
+        }
+        else if(strcmp(argv[i], "--timer") == 0 && i + 1 < argc && strcmp(argv[i + 1], "steady") == 0){
+            timing.source = TIMER_STEADY;
+            i++;
+        }
+        else if(strcmp(argv[i], "--timer") == 0 && i + 1 < argc && strcmp(argv[i + 1], "tsc") == 0){
+            timing.source = TIMER_TSC;
+            i++;
+        }
+        else if(strcmp(argv[i], "--sample") == 0 && i + 1 < argc){
+            timing.sampleEvery = atoi(argv[++i]);
+        }
+        else{
+            cout << "Usage: " << argv[0] << " [-j workers] [--pin] [--serial-timing] [--timer steady|tsc] [--sample N]" << endl;
+            return 1;
+        }
+    }
+    if(numWorkers < 1) numWorkers = 1;
+    if(timing.sampleEvery < 1) timing.sampleEvery = 1;
+    if(timing.source == TIMER_TSC && !OpTimer::tscSupported()){
+        cout << "No invariant TSC on this CPU; timing with steady_clock" << endl;
+        timing.source = TIMER_STEADY;
+    }
     
     cout << "Loading URLs from " << filename << "..." << endl;
     vector<string> urls = loadURLsFromFile(filename, originalSize);
@@ -108,9 +263,26 @@ int main(){
     }
     
     cout << "Loaded " << urls.size() << " URLs." << endl;
-    cout << "\nRunning all configurations (this will take a few minutes)...\n" << endl;
+    cout << "\nRunning all configurations (this will take a few minutes)..." << endl;
+    cout << "Workers: " << numWorkers << (pin ? ", pinned" : "")
+         << (serialTiming ? ", serialized timing" : "") << endl;
+    cout << "Timer: " << OpTimer::sourceName(timing.source);
+    if(timing.sampleEvery > 1){
+        cout << ", every " << timing.sampleEvery << "th insert";
+    }
+    cout << "\n" << endl;
+    if(numWorkers > 1 && !serialTiming){
+        cout << "Note: AvgTime is measured beside concurrent runs; use --serial-timing for timing data\n" << endl;
+    }
     
     int numURLs = urls.size();
+    
+    // Same number of URLs that are never inserted, for the miss searches
+    vector<string> absent;
+    for(const string& url : urls){
+        absent.push_back(url + "?absent");
+    }
+    
     vector<int> tableSizes;
     tableSizes.push_back(numURLs * 3);
     tableSizes.push_back(numURLs * 2);
@@ -125,47 +297,106 @@ int main(){
     
     vector<TestResult> allResults;
     
-    // Test all 6 configurations
+    // Test all 43 configurations: the original hashes under every engine,
+    // the wide kernels (same slots, so linear only) and each registry hash
+    // from FastHashes under every engine
+    typedef TestResult (*TestRunner)(int, const vector<string>&, const vector<string>&, HashType, ProbingMethod, const string&, const string&, const TimerSettings&, TimingGate&);
     struct Config {
         HashType hashType;
         string hashName;
         ProbingMethod probingType;
         string probeName;
+        TestRunner run;
     };
     
     Config configs[] = {
-        {BITWISE_HASH, "Bitwise", LINEAR_PROBING, "Linear"},
-        {BITWISE_HASH, "Bitwise", QUADRATIC_PROBING, "Quadratic"},
-        {POLYNOMIAL_HASH, "Polynomial", LINEAR_PROBING, "Linear"},
-        {POLYNOMIAL_HASH, "Polynomial", QUADRATIC_PROBING, "Quadratic"},
-        {UNIVERSAL_HASH, "Universal", LINEAR_PROBING, "Linear"},
-        {UNIVERSAL_HASH, "Universal", QUADRATIC_PROBING, "Quadratic"}
+        {BITWISE_HASH, "Bitwise", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<BitwiseHashPolicy, LinearProbePolicy> >},
+        {BITWISE_HASH, "Bitwise", QUADRATIC_PROBING, "Quadratic", runTest<BasicURLHashTable<BitwiseHashPolicy, QuadraticProbePolicy> >},
+        {POLYNOMIAL_HASH, "Polynomial", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<PolynomialHashPolicy, LinearProbePolicy> >},
+        {POLYNOMIAL_HASH, "Polynomial", QUADRATIC_PROBING, "Quadratic", runTest<BasicURLHashTable<PolynomialHashPolicy, QuadraticProbePolicy> >},
+        {UNIVERSAL_HASH, "Universal", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<UniversalHashPolicy, LinearProbePolicy> >},
+        {UNIVERSAL_HASH, "Universal", QUADRATIC_PROBING, "Quadratic", runTest<BasicURLHashTable<UniversalHashPolicy, QuadraticProbePolicy> >},
+        {BITWISE_HASH, "Bitwise", ROBIN_HOOD_PROBING, "RobinHood", runTest<BasicURLHashTable<BitwiseHashPolicy, RobinHoodProbePolicy> >},
+        {POLYNOMIAL_HASH, "Polynomial", ROBIN_HOOD_PROBING, "RobinHood", runTest<BasicURLHashTable<PolynomialHashPolicy, RobinHoodProbePolicy> >},
+        {UNIVERSAL_HASH, "Universal", ROBIN_HOOD_PROBING, "RobinHood", runTest<BasicURLHashTable<UniversalHashPolicy, RobinHoodProbePolicy> >},
+        {BITWISE_HASH, "Bitwise", LINEAR_PROBING, "Swiss", runTest<SwissHashTable>},
+        {POLYNOMIAL_HASH, "Polynomial", LINEAR_PROBING, "Swiss", runTest<SwissHashTable>},
+        {UNIVERSAL_HASH, "Universal", LINEAR_PROBING, "Swiss", runTest<SwissHashTable>},
+        {BITWISE_HASH, "Bitwise", LINEAR_PROBING, "Cuckoo", runTest<CuckooHashTable>},
+        {POLYNOMIAL_HASH, "Polynomial", LINEAR_PROBING, "Cuckoo", runTest<CuckooHashTable>},
+        {UNIVERSAL_HASH, "Universal", LINEAR_PROBING, "Cuckoo", runTest<CuckooHashTable>},
+        {BITWISE_WIDE_HASH, "BitwiseWide", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<BitwiseWideHashPolicy, LinearProbePolicy> >},
+        {POLYNOMIAL_WIDE_HASH, "PolynomialWide", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<PolynomialWideHashPolicy, LinearProbePolicy> >},
+        {UNIVERSAL_WIDE_HASH, "UniversalWide", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<UniversalWideHashPolicy, LinearProbePolicy> >},
+        {XXHASH64_HASH, "XXHash64", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<XXHash64HashPolicy, LinearProbePolicy> >},
+        {XXHASH64_HASH, "XXHash64", QUADRATIC_PROBING, "Quadratic", runTest<BasicURLHashTable<XXHash64HashPolicy, QuadraticProbePolicy> >},
+        {XXHASH64_HASH, "XXHash64", ROBIN_HOOD_PROBING, "RobinHood", runTest<BasicURLHashTable<XXHash64HashPolicy, RobinHoodProbePolicy> >},
+        {XXHASH64_HASH, "XXHash64", LINEAR_PROBING, "Swiss", runTest<SwissHashTable>},
+        {XXHASH64_HASH, "XXHash64", LINEAR_PROBING, "Cuckoo", runTest<CuckooHashTable>},
+        {WYHASH_HASH, "Wyhash", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<WyhashHashPolicy, LinearProbePolicy> >},
+        {WYHASH_HASH, "Wyhash", QUADRATIC_PROBING, "Quadratic", runTest<BasicURLHashTable<WyhashHashPolicy, QuadraticProbePolicy> >},
+        {WYHASH_HASH, "Wyhash", ROBIN_HOOD_PROBING, "RobinHood", runTest<BasicURLHashTable<WyhashHashPolicy, RobinHoodProbePolicy> >},
+        {WYHASH_HASH, "Wyhash", LINEAR_PROBING, "Swiss", runTest<SwissHashTable>},
+        {WYHASH_HASH, "Wyhash", LINEAR_PROBING, "Cuckoo", runTest<CuckooHashTable>},
+        {FNV1A_HASH, "FNV1a", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<Fnv1aHashPolicy, LinearProbePolicy> >},
+        {FNV1A_HASH, "FNV1a", QUADRATIC_PROBING, "Quadratic", runTest<BasicURLHashTable<Fnv1aHashPolicy, QuadraticProbePolicy> >},
+        {FNV1A_HASH, "FNV1a", ROBIN_HOOD_PROBING, "RobinHood", runTest<BasicURLHashTable<Fnv1aHashPolicy, RobinHoodProbePolicy> >},
+        {FNV1A_HASH, "FNV1a", LINEAR_PROBING, "Swiss", runTest<SwissHashTable>},
+        {FNV1A_HASH, "FNV1a", LINEAR_PROBING, "Cuckoo", runTest<CuckooHashTable>},
+        {MURMUR3_HASH, "Murmur3", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<Murmur3HashPolicy, LinearProbePolicy> >},
+        {MURMUR3_HASH, "Murmur3", QUADRATIC_PROBING, "Quadratic", runTest<BasicURLHashTable<Murmur3HashPolicy, QuadraticProbePolicy> >},
+        {MURMUR3_HASH, "Murmur3", ROBIN_HOOD_PROBING, "RobinHood", runTest<BasicURLHashTable<Murmur3HashPolicy, RobinHoodProbePolicy> >},
+        {MURMUR3_HASH, "Murmur3", LINEAR_PROBING, "Swiss", runTest<SwissHashTable>},
+        {MURMUR3_HASH, "Murmur3", LINEAR_PROBING, "Cuckoo", runTest<CuckooHashTable>},
+        {CRC32C_HASH, "CRC32C", LINEAR_PROBING, "Linear", runTest<BasicURLHashTable<Crc32cHashPolicy, LinearProbePolicy> >},
+        {CRC32C_HASH, "CRC32C", QUADRATIC_PROBING, "Quadratic", runTest<BasicURLHashTable<Crc32cHashPolicy, QuadraticProbePolicy> >},
+        {CRC32C_HASH, "CRC32C", ROBIN_HOOD_PROBING, "RobinHood", runTest<BasicURLHashTable<Crc32cHashPolicy, RobinHoodProbePolicy> >},
+        {CRC32C_HASH, "CRC32C", LINEAR_PROBING, "Swiss", runTest<SwissHashTable>},
+        {CRC32C_HASH, "CRC32C", LINEAR_PROBING, "Cuckoo", runTest<CuckooHashTable>}
     };
+    const int numConfigs = sizeof(configs) / sizeof(configs[0]);
     
-    int totalTests = 6 * tableSizes.size();
-    int currentTest = 0;
+    int totalTests = numConfigs * tableSizes.size();
     
-    for(const auto& config : configs){
-        cout << "\n========================================" << endl;
-        cout << "Testing: " << config.hashName << " + " << config.probeName << endl;
-        cout << "========================================" << endl;
-        
-        for(size_t i = 0; i < tableSizes.size(); i++){
-            currentTest++;
-            int size = tableSizes[i];
-            double expectedLoadFactor = (double)numURLs / size;
-            
-            cout << "Progress: " << currentTest << "/" << totalTests 
-                 << " - Size: " << size << " (α=" << fixed << setprecision(2) 
-                 << expectedLoadFactor << ")..." << flush;
+    // Job j is configuration j / 10 at table size j % 10. Workers claim jobs
+    // in order and write each result to its own slot
+    allResults.resize(totalTests);
+    atomic<int> nextJob(0);
+    int completed = 0;
+    mutex outputLock;
+    TimingGate gate(serialTiming);
+    
+    auto work = [&]() {
+        for(int job = nextJob++; job < totalTests; job = nextJob++){
+            const Config& config = configs[job / tableSizes.size()];
+            int size = tableSizes[job % tableSizes.size()];
             
-            TestResult result = runTest(size, urls, config.hashType, config.probingType, 
-                                       config.hashName, config.probeName);
-            allResults.push_back(result);
+            allResults[job] = config.run(size, urls, absent, config.hashType, config.probingType, 
+                                         config.hashName, config.probeName, timing, gate);
             
-            cout << " Done!" << endl;
+            lock_guard<mutex> guard(outputLock);
+            completed++;
+            cout << "Progress: " << completed << "/" << totalTests 
+                 << " - " << config.hashName << " + " << config.probeName
+                 << ", Size: " << size << " (α=" << fixed << setprecision(2) 
+                 << (double)numURLs / size << ")... Done!" << endl;
+        }
+    };
+    
+    int numCPUs = thread::hardware_concurrency();
+    if(numCPUs < 1) numCPUs = 1;
+    
+    vector<thread> workers;
+    for(int w = 0; w < numWorkers; w++){
+        workers.push_back(thread(work));
+        if(pin && !pinThread(workers.back(), w % numCPUs)){
+            lock_guard<mutex> guard(outputLock);
+            cout << "Could not pin worker " << w << endl;
         }
     }
+    for(thread& worker : workers){
+        worker.join();
+    }
     
     // Export to CSV
     ofstream csvFile("test_results.csv");
@@ -183,6 +414,35 @@ int main(){
     }
     csvFile.close();
     
+    // Percentiles of every operation type, one row per run, operation and
+    // metric (latency rows cover the timed operations only)
+    ofstream pctFile("test_percentiles.csv");
+    pctFile << "HashFunction,ProbingMethod,TableSize,Operation,Metric,Count,P50,P90,P99,P999,Max\n";
+    
+    const char* opNames[] = {"SearchHit", "SearchMiss", "Insert", "Delete"};
+    for(const auto& result : allResults){
+        for(int k = 0; k < NUM_OP_KINDS; k++){
+            const LogHistogram* histograms[] = {&result.stats.getProbeHistogram((OpKind)k),
+                                                &result.stats.getLatencyHistogram((OpKind)k)};
+            const char* metrics[] = {"Probes", "LatencyNs"};
+            for(int m = 0; m < 2; m++){
+                const LogHistogram& h = *histograms[m];
+                pctFile << result.hashFunction << ","
+                        << result.probingMethod << ","
+                        << result.tableSize << ","
+                        << opNames[k] << ","
+                        << metrics[m] << ","
+                        << h.getCount() << ","
+                        << h.percentile(50) << ","
+                        << h.percentile(90) << ","
+                        << h.percentile(99) << ","
+                        << h.percentile(99.9) << ","
+                        << h.getMax() << "\n";
+            }
+        }
+    }
+    pctFile.close();
+    
     // Also create Python-ready data file
     ofstream pyFile("test_data.py");
     pyFile << "# Test results collected on " << __DATE__ << "\n\n";
@@ -200,10 +460,19 @@ int main(){
     string configNames[] = {
         "bitwise_linear", "bitwise_quad",
         "poly_linear", "poly_quad",
-        "universal_linear", "universal_quad"
+        "universal_linear", "universal_quad",
+        "bitwise_robin", "poly_robin", "universal_robin",
+        "bitwise_swiss", "poly_swiss", "universal_swiss",
+        "bitwise_cuckoo", "poly_cuckoo", "universal_cuckoo",
+        "bitwise_wide_linear", "poly_wide_linear", "universal_wide_linear",
+        "xxhash64_linear", "xxhash64_quad", "xxhash64_robin", "xxhash64_swiss", "xxhash64_cuckoo",
+        "wyhash_linear", "wyhash_quad", "wyhash_robin", "wyhash_swiss", "wyhash_cuckoo",
+        "fnv1a_linear", "fnv1a_quad", "fnv1a_robin", "fnv1a_swiss", "fnv1a_cuckoo",
+        "murmur3_linear", "murmur3_quad", "murmur3_robin", "murmur3_swiss", "murmur3_cuckoo",
+        "crc32c_linear", "crc32c_quad", "crc32c_robin", "crc32c_swiss", "crc32c_cuckoo"
     };
     
-    for(int c = 0; c < 6; c++){
+    for(int c = 0; c < numConfigs; c++){
         pyFile << "    '" << configNames[c] << "_avg': [";
         for(int i = 0; i < 10; i++){
             pyFile << fixed << setprecision(6) << allResults[c*10 + i].avgComparisons;
@@ -236,6 +505,7 @@ int main(){
     cout << "\nOutput files created:" << endl;
     cout << "  1. test_results.csv - Raw data in CSV format" << endl;
     cout << "  2. test_data.py - Python data ready for graphing" << endl;
+    cout << "  3. test_percentiles.csv - Probe and latency percentiles per operation type" << endl;
     cout << "\nNext steps:" << endl;
     cout << "  1. Copy test_data.py contents into generate_graphs.py" << endl;
     cout << "  2. Run: python generate_graphs.py" << endl;
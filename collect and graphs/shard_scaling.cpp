@@ -0,0 +1,153 @@
+// Sharded Table Scaling Benchmark
+// Fills a ShardedURLHashTable half full and measures lookup throughput with
+// 1 to N threads (N = hardware threads, or the first argument), each thread
+// searching random stored URLs for a fixed wall-clock interval. With one
+// shard every thread shares a single reader-writer lock, so the two shard
+// counts differ only in how much that lock's cache line is contended.
+// Results go to shard_scaling.csv
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include "include/ShardedURLHashTable.h"
+
+using namespace std;
+
+struct ScalingResult {
+    int shards;
+    int threads;
+    double mopsPerSec;
+    double scaling;  // Over one thread with the same shard count
+};
+
+//Distinct URLs of 30-60 bytes spread over a few thousand hosts
+vector<string> makeURLs(int count, mt19937& rng) {
+    const string chars = "abcdefghijklmnopqrstuvwxyz0123456789-_./";
+    vector<string> urls;
+    urls.reserve(count);
+    
+    for(int i = 0; i < count; i++){
+        string url = "http://www.site" + to_string(rng() % 5000) + ".com/" + to_string(i) + "/";
+        int length = 30 + rng() % 31;
+        while((int)url.size() < length){
+            url.push_back(chars[rng() % chars.size()]);
+        }
+        urls.push_back(url);
+    }
+    return urls;
+}
+
+//Each thread looks up random stored URLs until stop is set and adds its
+//count of completed lookups to total
+void lookupWorker(ShardedURLHashTable& table, const vector<string>& urls, unsigned seed,
+                  const atomic<bool>& stop, atomic<long>& total) {
+    mt19937 rng(seed);
+    long done = 0;
+    long hits = 0;
+    
+    while(!stop.load(memory_order_relaxed)){
+        for(int i = 0; i < 256; i++){
+            hits += table.search(urls[rng() % urls.size()]).success;
+        }
+        done += 256;
+    }
+    
+    if(hits != done){
+        cerr << "Lookup missed a stored URL" << endl;
+    }
+    total += done;
+}
+
+double measure(ShardedURLHashTable& table, const vector<string>& urls, int threads, double seconds) {
+    atomic<bool> stop(false);
+    atomic<long> total(0);
+    vector<thread> workers;
+    
+    auto start = chrono::steady_clock::now();
+    for(int t = 0; t < threads; t++){
+        workers.push_back(thread(lookupWorker, ref(table), cref(urls), 1000u + t, cref(stop), ref(total)));
+    }
+    this_thread::sleep_for(chrono::duration<double>(seconds));
+    stop = true;
+    for(thread& worker : workers){
+        worker.join();
+    }
+    auto end = chrono::steady_clock::now();
+    
+    return total / chrono::duration<double>(end - start).count() / 1e6;
+}
+
+void writeCSV(const vector<ScalingResult>& results, const string& filename) {
+    ofstream file(filename);
+    file << "Shards,Threads,MopsPerSec,Scaling\n";
+    for(const ScalingResult& r : results){
+        file << r.shards << "," << r.threads << ","
+             << fixed << setprecision(4) << r.mopsPerSec << "," << r.scaling << "\n";
+    }
+    file.close();
+    cout << "Output file created: " << filename << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+    if(maxThreads < 1) maxThreads = 1;
+    
+    const int tableSize = 1 << 22;
+    const int shardCounts[] = {1, 64};
+    const double secondsPerRun = 0.5;
+    
+    vector<int> threadCounts;
+    for(int t = 1; t < maxThreads; t *= 2){
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+    
+    cout << "Sharded Table Scaling Benchmark" << endl;
+    cout << "(" << tableSize << " slots half full, wyhash + linear probing, lookups only, up to "
+         << maxThreads << " threads)" << endl << endl;
+    
+    mt19937 rng(12345);
+    vector<string> urls = makeURLs(tableSize / 2, rng);
+    vector<ScalingResult> results;
+    
+    cout << left << setw(10) << "Shards" << setw(10) << "Threads"
+         << setw(12) << "Mops/s" << "Scaling" << endl;
+    cout << string(40, '-') << endl;
+    
+    for(int shards : shardCounts){
+        ShardedURLHashTable table(tableSize, shards);
+        table.setHashFunction(WYHASH_HASH);
+        for(const string& url : urls){
+            table.insert(url);
+        }
+        
+        double oneThread = 0;
+        for(int threads : threadCounts){
+            ScalingResult result;
+            result.shards = shards;
+            result.threads = threads;
+            result.mopsPerSec = measure(table, urls, threads, secondsPerRun);
+            if(threads == 1){
+                oneThread = result.mopsPerSec;
+            }
+            result.scaling = result.mopsPerSec / oneThread;
+            results.push_back(result);
+            
+            cout << left << setw(10) << shards << setw(10) << threads
+                 << setw(12) << fixed << setprecision(2) << result.mopsPerSec
+                 << result.scaling << "x" << endl;
+        }
+        cout << endl;
+    }
+    
+    writeCSV(results, "shard_scaling.csv");
+    
+    return 0;
+}
@@ -0,0 +1,178 @@
+// Streaming Ingest Benchmark
+// Streams a URL file (default test1.txt) into a growing table through
+// URLStreamPipeline: read, parse, hash and insert stages on their own
+// threads, linked by bounded queues. Prints each stage's throughput, the
+// queue occupancy and the process's peak RSS. With --preload the file is
+// instead loaded whole into a vector<string> and inserted from there, the
+// way the other tools work, for comparison (run the modes as separate
+// processes: peak RSS only ever grows).
+// Results go to stream_ingest.csv
+//
+// Usage: stream_ingest [file] [--preload] [--block KB] [--batch N] [--depth N]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+#include "include/URLHashTable.h"
+#include "include/URLStreamPipeline.h"
+#include "include/MappedURLFile.h"
+
+using namespace std;
+
+//Peak resident set size in MB, or -1 where it is not available
+double peakRSSMB() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1e6;  // Bytes
+#else
+    return usage.ru_maxrss / 1e3;  // Kilobytes
+#endif
+#else
+    return -1;
+#endif
+}
+
+void printPeakRSS() {
+    double rss = peakRSSMB();
+    cout << "Peak RSS: ";
+    if(rss < 0){
+        cout << "n/a" << endl;
+    }
+    else{
+        cout << fixed << setprecision(1) << rss << " MB" << endl;
+    }
+}
+
+//Table both modes insert into: starts small and grows as the URLs arrive,
+//since a stream's size is not known up front
+URLHashTable* makeTable() {
+    URLHashTable* table = new URLHashTable(1024);
+    table->setHashFunction(WYHASH_HASH);
+    table->setMaxLoadFactor(0.5);
+    return table;
+}
+
+int main(int argc, char* argv[]) {
+    string filename = "test1.txt";
+    bool preload = false;
+    size_t blockKB = 64;
+    int batchSize = 256;
+    int depth = 8;
+    
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--preload") == 0){
+            preload = true;
+        }
+        else if(strcmp(argv[i], "--block") == 0 && i + 1 < argc){
+            blockKB = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--batch") == 0 && i + 1 < argc){
+            batchSize = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--depth") == 0 && i + 1 < argc){
+            depth = atoi(argv[++i]);
+        }
+        else if(argv[i][0] != '-'){
+            filename = argv[i];
+        }
+        else{
+            cout << "Usage: " << argv[0] << " [file] [--preload] [--block KB] [--batch N] [--depth N]" << endl;
+            return 1;
+        }
+    }
+    if(blockKB < 1) blockKB = 1;
+    if(batchSize < 1) batchSize = 1;
+    if(depth < 1) depth = 1;
+    
+    URLHashTable* table = makeTable();
+    ofstream csvFile("stream_ingest.csv");
+    csvFile << "Mode,Stage,Items,MB,BusySeconds,ItemsPerSecBusy,QueueCapacity,QueueAvg,QueueMax,FullWaits,EmptyWaits,PeakRSSMB\n";
+    
+    if(preload){
+        cout << "Preloaded Ingest: " << filename << endl;
+        auto start = chrono::steady_clock::now();
+        
+        vector<string> urls;
+        MappedURLFile urlFile;
+        if(!urlFile.open(filename, 1)){
+            cout << "Error opening file: " << filename << endl;
+            delete table;
+            return 1;
+        }
+        double mb = urlFile.getFileBytes() / 1e6;
+        for(const URLView& url : urlFile.getURLs()){
+            urls.push_back(url.str());
+        }
+        urlFile.close();
+        
+        vector<OpResult> results(batchSize);
+        long inserted = 0;
+        for(size_t i = 0; i < urls.size(); i += batchSize){
+            int count = min((size_t)batchSize, urls.size() - i);
+            table->insertBatch(&urls[i], count, &results[0]);
+            for(int j = 0; j < count; j++){
+                if(results[j].success) inserted++;
+            }
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        
+        cout << urls.size() << " URLs, " << inserted << " inserted in " << fixed << setprecision(4)
+             << seconds << " s (" << setprecision(0) << urls.size() / seconds << " URLs/s)" << endl;
+        printPeakRSS();
+        csvFile << "preload,Total," << urls.size() << "," << fixed << setprecision(4) << mb << ","
+                << seconds << "," << setprecision(0) << urls.size() / seconds << ",,,,,,"
+                << setprecision(1) << peakRSSMB() << "\n";
+    }
+    else{
+        cout << "Streaming Ingest: " << filename << " (" << blockKB << " KB blocks, "
+             << batchSize << " URLs per batch, queue depth " << depth << ")" << endl;
+        
+        URLStreamPipeline pipeline(*table);
+        pipeline.setBlockBytes(blockKB * 1024);
+        pipeline.setBatchSize(batchSize);
+        pipeline.setQueueDepth(depth);
+        if(!pipeline.run(filename)){
+            cout << "Error opening file: " << filename << endl;
+            delete table;
+            return 1;
+        }
+        
+        pipeline.displayStats();
+        printPeakRSS();
+        
+        double rss = peakRSSMB();
+        for(int i = 0; i < URLStreamPipeline::NUM_STAGES; i++){
+            const PipelineStage& s = pipeline.getStage(i);
+            csvFile << "stream," << s.name << "," << s.items << "," << fixed << setprecision(4)
+                    << s.bytes / 1e6 << "," << s.busySeconds << "," << setprecision(0)
+                    << (s.busySeconds > 0 ? s.items / s.busySeconds : 0.0) << ",";
+            if(i > 0){
+                const PipelineQueue& q = pipeline.getQueue(i - 1);
+                csvFile << q.capacity << "," << setprecision(2) << q.avgOccupancy << ","
+                        << q.maxOccupancy << "," << q.fullWaits << "," << q.emptyWaits;
+            }
+            else{
+                csvFile << ",,,,";
+            }
+            csvFile << "," << setprecision(1) << rss << "\n";
+        }
+    }
+    
+    cout << "Table: " << table->getNumElements() << " URLs in " << table->getSize() << " slots" << endl;
+    csvFile.close();
+    cout << "Output file created: stream_ingest.csv" << endl;
+    
+    delete table;
+    return 0;
+}
@@ -0,0 +1,254 @@
+// Trace Replay Driver
+// Replays an operation trace (OpTrace.h: text lines as typed in interactive
+// mode, or the binary format) at full speed against one table
+// configuration, with no prompts or per-operation output. Traces come from
+// interactive mode's recording option, workload_gen --ops-file or captured
+// traffic converted to either format. Prints throughput, the results per
+// command and the table's statistics with latency and probe percentiles.
+//   --load FILE    Inserts a URL file (the usual input format) first, e.g.
+//                  the corpus the trace was generated against; not timed
+//   --size N       Starting table size (default 1024)
+//   --grow LF      Max load factor for growth; 0 keeps the size fixed
+//                  (default 0.5 when --size is not given, else 0)
+//   --convert OUT  Writes the trace to OUT instead of replaying it, binary
+//                  when OUT ends in .bin and text otherwise
+//   --profile CSV  After the replay, prints the table's cluster/displacement
+//                  profile (TableProfile) and writes it to CSV
+// Percentiles go to trace_replay.csv
+//
+// Usage: trace_replay TRACE [--load FILE] [--size N] [--grow LF] [--hash NAME]
+//                     [--probe linear|quadratic|robinhood] [--encode]
+//                     [--sample N] [--timer steady|tsc] [--convert OUT]
+//                     [--profile CSV]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "include/URLHashTable.h"
+#include "include/HashRegistry.h"
+#include "include/MappedURLFile.h"
+#include "include/OpTrace.h"
+
+using namespace std;
+
+int convertTrace(TraceReader& reader, const string& output) {
+    TraceWriter writer;
+    if(!writer.open(output, TraceWriter::isBinaryName(output))){
+        cout << "Error opening file: " << output << endl;
+        return 1;
+    }
+    TraceRecord record;
+    while(reader.next(record)){
+        writer.write(record.command, record.url);
+    }
+    writer.close();
+    cout << writer.getCount() << " records written to " << output << " ("
+         << (TraceWriter::isBinaryName(output) ? "binary" : "text") << ")" << endl;
+    return 0;
+}
+
+//Inserts every URL of a file before the replay; the stats are reset after
+bool loadTable(URLHashTable& table, const string& filename) {
+    MappedURLFile urlFile;
+    if(!urlFile.open(filename, (int)thread::hardware_concurrency())){
+        cout << "Error opening file: " << filename << endl;
+        return false;
+    }
+    
+    const int batch = 4096;
+    vector<string> urls(batch);
+    vector<OpResult> results(batch);
+    const vector<URLView>& views = urlFile.getURLs();
+    auto start = chrono::steady_clock::now();
+    for(size_t first = 0; first < views.size(); first += batch){
+        int count = (int)min((size_t)batch, views.size() - first);
+        for(int i = 0; i < count; i++){
+            urls[i].assign(views[first + i].data, views[first + i].len);
+        }
+        table.insertBatch(&urls[0], count, &results[0]);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Loaded " << table.getNumElements() << " URLs from " << filename << " in " << fixed
+         << setprecision(2) << seconds << " s" << endl;
+    table.resetStats();
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    string traceFile, loadFile, convertFile, profileFile;
+    int size = 1024;
+    bool sizeGiven = false;
+    double grow = -1;
+    HashType hashType = WYHASH_HASH;
+    ProbingMethod probingType = LINEAR_PROBING;
+    bool encode = false;
+    int sampleEvery = 1;
+    TimerSource timer = TIMER_STEADY;
+    bool usage = false;
+    
+    for(int i = 1; i < argc && !usage; i++){
+        bool hasValue = i + 1 < argc;
+        if(strcmp(argv[i], "--load") == 0 && hasValue){
+            loadFile = argv[++i];
+        }
+        else if(strcmp(argv[i], "--size") == 0 && hasValue){
+            size = atoi(argv[++i]);
+            sizeGiven = true;
+            usage = size < 1;
+        }
+        else if(strcmp(argv[i], "--grow") == 0 && hasValue){
+            grow = atof(argv[++i]);
+            usage = grow < 0;
+        }
+        else if(strcmp(argv[i], "--hash") == 0 && hasValue){
+            i++;
+            usage = true;
+            for(int h = 0; h < HashRegistry::count(); h++){
+                if(strcmp(HashRegistry::get(h).shortName, argv[i]) == 0){
+                    hashType = HashRegistry::get(h).type;
+                    usage = false;
+                }
+            }
+        }
+        else if(strcmp(argv[i], "--probe") == 0 && hasValue){
+            i++;
+            if(strcmp(argv[i], "linear") == 0) probingType = LINEAR_PROBING;
+            else if(strcmp(argv[i], "quadratic") == 0) probingType = QUADRATIC_PROBING;
+            else if(strcmp(argv[i], "robinhood") == 0) probingType = ROBIN_HOOD_PROBING;
+            else usage = true;
+        }
+        else if(strcmp(argv[i], "--encode") == 0){
+            encode = true;
+        }
+        else if(strcmp(argv[i], "--sample") == 0 && hasValue){
+            sampleEvery = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--timer") == 0 && hasValue){
+            i++;
+            if(strcmp(argv[i], "steady") == 0) timer = TIMER_STEADY;
+            else if(strcmp(argv[i], "tsc") == 0) timer = TIMER_TSC;
+            else usage = true;
+        }
+        else if(strcmp(argv[i], "--convert") == 0 && hasValue){
+            convertFile = argv[++i];
+        }
+        else if(strcmp(argv[i], "--profile") == 0 && hasValue){
+            profileFile = argv[++i];
+        }
+        else if(argv[i][0] != '-' && traceFile.empty()){
+            traceFile = argv[i];
+        }
+        else{
+            usage = true;
+        }
+    }
+    if(usage || traceFile.empty()){
+        cout << "Usage: " << argv[0] << " TRACE [--load FILE] [--size N] [--grow LF] [--hash NAME]" << endl
+             << "       [--probe linear|quadratic|robinhood] [--encode] [--sample N]" << endl
+             << "       [--timer steady|tsc] [--convert OUT] [--profile CSV]" << endl;
+        cout << "Hash names:";
+        for(int h = 0; h < HashRegistry::count(); h++){
+            cout << " " << HashRegistry::get(h).shortName;
+        }
+        cout << endl;
+        return 1;
+    }
+    if(sampleEvery < 0) sampleEvery = 0;
+    if(grow < 0) grow = sizeGiven ? 0 : 0.5;
+    
+    TraceReader reader;
+    if(!reader.open(traceFile)){
+        cout << "Error opening file: " << traceFile << endl;
+        return 1;
+    }
+    if(!convertFile.empty()){
+        return convertTrace(reader, convertFile);
+    }
+    
+    URLHashTable table(size);
+    table.setHashFunction(hashType);
+    table.setProbingMethod(probingType);
+    table.setMaxLoadFactor(grow);
+    table.setKeyEncoding(encode);
+    table.setSampleInterval(sampleEvery);
+    if(!table.setTimerSource(timer)){
+        cout << "No invariant TSC on this CPU; timing with steady_clock" << endl;
+    }
+    
+    cout << "Trace Replay: " << traceFile << " (" << (reader.isBinary() ? "binary" : "text") << ")" << endl;
+    cout << "Table: " << HashRegistry::find(hashType).name << ", "
+         << (probingType == LINEAR_PROBING ? "linear" : probingType == QUADRATIC_PROBING ? "quadratic" : "Robin Hood")
+         << " probing, " << size << " slots";
+    if(grow > 0){
+        cout << ", growing past load factor " << grow;
+    }
+    cout << endl;
+    
+    if(!loadFile.empty() && !loadTable(table, loadFile)){
+        return 1;
+    }
+    
+    TraceReplayer replayer(table);
+    ReplaySummary summary = replayer.replay(reader);
+    
+    cout << "\nReplayed " << summary.totalOps << " operations in " << fixed << setprecision(4)
+         << summary.seconds << " s (" << setprecision(2)
+         << (summary.seconds > 0 ? summary.totalOps / summary.seconds / 1e6 : 0.0) << " Mops/s)" << endl;
+    for(int c = 0; c < NUM_TRACE_COMMANDS; c++){
+        if(summary.ops[c] == 0) continue;
+        cout << "  " << left << setw(12) << TraceReader::commandName((TraceCommand)c) << right
+             << setw(10) << summary.ops[c];
+        if(c != TRACE_COMPACT){
+            cout << "  (" << summary.succeeded[c] << " succeeded)";
+        }
+        cout << endl;
+    }
+    if(reader.getSkipped() > 0){
+        cout << "Skipped " << reader.getSkipped() << " unrecognized lines" << endl;
+    }
+    cout << "Table holds " << table.getNumElements() << " URLs in " << table.getSize() << " slots" << endl << endl;
+    
+    table.displayStats();
+    
+    // Percentiles per operation type, as in run_all_tests' test_percentiles.csv
+    ofstream pctFile("trace_replay.csv");
+    pctFile << "Operation,Metric,Count,P50,P90,P99,P999,Max\n";
+    const char* opNames[] = {"SearchHit", "SearchMiss", "Insert", "Delete"};
+    const Statistics& stats = table.getStats();
+    for(int k = 0; k < NUM_OP_KINDS; k++){
+        const LogHistogram* histograms[] = {&stats.getProbeHistogram((OpKind)k),
+                                            &stats.getLatencyHistogram((OpKind)k)};
+        const char* metrics[] = {"Probes", "LatencyNs"};
+        for(int m = 0; m < 2; m++){
+            const LogHistogram& h = *histograms[m];
+            pctFile << opNames[k] << ","
+                    << metrics[m] << ","
+                    << h.getCount() << ","
+                    << h.percentile(50) << ","
+                    << h.percentile(90) << ","
+                    << h.percentile(99) << ","
+                    << h.percentile(99.9) << ","
+                    << h.getMax() << "\n";
+        }
+    }
+    pctFile.close();
+    cout << "\nOutput file created: trace_replay.csv" << endl;
+    
+    if(!profileFile.empty()){
+        TableProfile profile;
+        table.profileTable(profile, 10);
+        profile.display();
+        ofstream csvFile(profileFile);
+        profile.writeCSV(csvFile);
+        cout << "\nOutput file created: " << profileFile << endl;
+    }
+    
+    return 0;
+}
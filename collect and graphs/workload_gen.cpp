@@ -0,0 +1,303 @@
+// Synthetic Workload Generator
+// Builds a seeded URL corpus of any size (URLCorpus: Zipfian host
+// popularity, realistic path and length profile) and a YCSB-style operation
+// stream over it (OperationStream: search-hit / search-miss / insert /
+// delete mix, Zipfian or uniform key popularity). The same seed always gives
+// the same corpus and stream. Outputs:
+//   --corpus FILE  The keys in the input format every tool reads: table
+//                  size on the first line, then one URL per line
+//   --ops-file F   The operations, one per line: hashSearch,<URL>,
+//                  hashInsert,<URL> or hashDelete,<URL>
+//   --run          Loads the keys into a URLHashTable, runs the operations
+//                  against it and prints throughput and its statistics
+//
+// Usage: workload_gen [--keys N] [--seed S] [--corpus FILE] [--ops N]
+//                     [--ops-file FILE] [--mix hit,miss,insert,delete]
+//                     [--dist zipf|uniform] [--theta T] [--run]
+//                     [--hash NAME] [--probe linear|quadratic|robinhood]
+//                     [--sample N]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include "include/URLWorkload.h"
+#include "include/URLHashTable.h"
+#include "include/HashRegistry.h"
+
+using namespace std;
+
+struct WorkloadSettings {
+    long long keys;
+    unsigned long long seed;
+    long long ops;
+    OpMix mix;
+    bool zipfian;
+    double theta;
+};
+
+const char* opCommand(OpKind kind) {
+    switch(kind){
+        case OP_INSERT: return "hashInsert";
+        case OP_DELETE: return "hashDelete";
+        default: return "hashSearch";
+    }
+}
+
+bool writeCorpus(const URLCorpus& corpus, long long keys, const string& filename) {
+    ofstream file(filename, ios::binary);
+    if(!file.is_open()){
+        cout << "Error opening file: " << filename << endl;
+        return false;
+    }
+    
+    string url, buffer;
+    file << keys << "\n";
+    for(long long key = 0; key < keys; key++){
+        corpus.url(key, false, url);
+        buffer += url;
+        buffer.push_back('\n');
+        if(buffer.size() >= (1 << 20)){
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), buffer.size());
+    cout << "Corpus: " << keys << " URLs written to " << filename << endl;
+    return true;
+}
+
+bool writeOps(const URLCorpus& corpus, const WorkloadSettings& settings, const string& filename) {
+    ofstream file(filename, ios::binary);
+    if(!file.is_open()){
+        cout << "Error opening file: " << filename << endl;
+        return false;
+    }
+    
+    OperationStream stream(corpus, settings.keys, settings.mix, settings.zipfian, settings.theta, settings.seed + 1);
+    string url, buffer;
+    for(long long i = 0; i < settings.ops; i++){
+        WorkloadOp op = stream.next();
+        stream.url(op, url);
+        buffer += opCommand(op.kind);
+        buffer.push_back(',');
+        buffer += url;
+        buffer.push_back('\n');
+        if(buffer.size() >= (1 << 20)){
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), buffer.size());
+    cout << "Operations: " << settings.ops << " written to " << filename << endl;
+    return true;
+}
+
+//Loads the keys, then runs the stream in chunks: each chunk's URLs are
+//generated first so only the table operations are timed
+void runWorkload(const URLCorpus& corpus, const WorkloadSettings& settings, HashType hashType,
+                 ProbingMethod probingType, int sampleEvery) {
+    //Half full once the expected inserts are in, so growth rarely starts mid-run
+    const OpMix& mix = settings.mix;
+    double total = mix.searchHit + mix.searchMiss + mix.insert + mix.remove;
+    double inserts = total > 0 ? settings.ops * mix.insert / total : 0;
+    double slots = 2 * (settings.keys + inserts);
+    URLHashTable table((int)(slots > INT_MAX ? INT_MAX : (slots > 16 ? slots : 16)));
+    table.setHashFunction(hashType);
+    table.setProbingMethod(probingType);
+    table.setMaxLoadFactor(0.5);  // Inserts past the loaded keys grow it
+    table.setSampleInterval(sampleEvery);
+    
+    const int chunk = 65536;
+    vector<string> urls(chunk);
+    vector<OpResult> results(chunk);
+    
+    auto start = chrono::steady_clock::now();
+    for(long long first = 0; first < settings.keys; first += chunk){
+        int count = (int)min((long long)chunk, settings.keys - first);
+        for(int i = 0; i < count; i++){
+            corpus.url(first + i, false, urls[i]);
+        }
+        table.insertBatch(&urls[0], count, &results[0]);
+    }
+    double loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "\nLoaded " << table.getNumElements() << " URLs in " << fixed << setprecision(2)
+         << loadSeconds << " s (generation included)" << endl;
+    table.resetStats();
+    
+    OperationStream stream(corpus, settings.keys, settings.mix, settings.zipfian, settings.theta, settings.seed + 1);
+    vector<OpKind> kinds(chunk);
+    long long counts[NUM_OP_KINDS] = {0, 0, 0, 0};
+    long long unexpected = 0;
+    double opSeconds = 0;
+    
+    for(long long done = 0; done < settings.ops; done += chunk){
+        int count = (int)min((long long)chunk, settings.ops - done);
+        for(int i = 0; i < count; i++){
+            WorkloadOp op = stream.next();
+            kinds[i] = op.kind;
+            stream.url(op, urls[i]);
+        }
+        
+        auto chunkStart = chrono::steady_clock::now();
+        for(int i = 0; i < count; i++){
+            switch(kinds[i]){
+                case OP_INSERT: results[i] = table.insert(urls[i]); break;
+                case OP_DELETE: results[i] = table.remove(urls[i]); break;
+                default: results[i] = table.search(urls[i]); break;
+            }
+        }
+        opSeconds += chrono::duration<double>(chrono::steady_clock::now() - chunkStart).count();
+        
+        //Hits, inserts and deletes must succeed and misses must not
+        for(int i = 0; i < count; i++){
+            counts[kinds[i]]++;
+            if(results[i].success != (kinds[i] != OP_SEARCH_MISS)){
+                unexpected++;
+            }
+        }
+    }
+    
+    cout << "Ran " << settings.ops << " operations in " << setprecision(4) << opSeconds << " s ("
+         << setprecision(2) << (opSeconds > 0 ? settings.ops / opSeconds / 1e6 : 0.0) << " Mops/s)" << endl;
+    for(int kind = 0; kind < NUM_OP_KINDS; kind++){
+        cout << "  " << left << setw(12) << Statistics::opKindName((OpKind)kind) << right << counts[kind] << endl;
+    }
+    cout << "Unexpected results: " << unexpected << " (table full, or a bug)" << endl;
+    cout << "Stored after the run: " << stream.getStored() << " keys, table holds "
+         << table.getNumElements() << endl << endl;
+    
+    table.displayStats();
+}
+
+bool parseMix(const char* text, OpMix& mix) {
+    double w[4];
+    if(sscanf(text, "%lf,%lf,%lf,%lf", &w[0], &w[1], &w[2], &w[3]) != 4){
+        return false;
+    }
+    mix.searchHit = w[0];
+    mix.searchMiss = w[1];
+    mix.insert = w[2];
+    mix.remove = w[3];
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    WorkloadSettings settings;
+    settings.keys = 100000;
+    settings.seed = 42;
+    settings.ops = 0;
+    settings.mix.searchHit = 90;
+    settings.mix.searchMiss = 5;
+    settings.mix.insert = 4;
+    settings.mix.remove = 1;
+    settings.zipfian = true;
+    settings.theta = 0.99;
+    
+    string corpusFile, opsFile;
+    bool run = false;
+    HashType hashType = WYHASH_HASH;
+    ProbingMethod probingType = LINEAR_PROBING;
+    int sampleEvery = 1;
+    bool usage = false;
+    
+    for(int i = 1; i < argc && !usage; i++){
+        bool hasValue = i + 1 < argc;
+        if(strcmp(argv[i], "--keys") == 0 && hasValue){
+            settings.keys = atoll(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && hasValue){
+            settings.seed = strtoull(argv[++i], 0, 10);
+        }
+        else if(strcmp(argv[i], "--corpus") == 0 && hasValue){
+            corpusFile = argv[++i];
+        }
+        else if(strcmp(argv[i], "--ops") == 0 && hasValue){
+            settings.ops = atoll(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--ops-file") == 0 && hasValue){
+            opsFile = argv[++i];
+        }
+        else if(strcmp(argv[i], "--mix") == 0 && hasValue){
+            usage = !parseMix(argv[++i], settings.mix);
+        }
+        else if(strcmp(argv[i], "--dist") == 0 && hasValue){
+            i++;
+            settings.zipfian = strcmp(argv[i], "uniform") != 0;
+            usage = settings.zipfian && strcmp(argv[i], "zipf") != 0;
+        }
+        else if(strcmp(argv[i], "--theta") == 0 && hasValue){
+            settings.theta = atof(argv[++i]);
+            usage = settings.theta <= 0 || settings.theta >= 1;
+        }
+        else if(strcmp(argv[i], "--run") == 0){
+            run = true;
+        }
+        else if(strcmp(argv[i], "--hash") == 0 && hasValue){
+            i++;
+            usage = true;
+            for(int h = 0; h < HashRegistry::count(); h++){
+                if(strcmp(HashRegistry::get(h).shortName, argv[i]) == 0){
+                    hashType = HashRegistry::get(h).type;
+                    usage = false;
+                }
+            }
+        }
+        else if(strcmp(argv[i], "--probe") == 0 && hasValue){
+            i++;
+            if(strcmp(argv[i], "linear") == 0) probingType = LINEAR_PROBING;
+            else if(strcmp(argv[i], "quadratic") == 0) probingType = QUADRATIC_PROBING;
+            else if(strcmp(argv[i], "robinhood") == 0) probingType = ROBIN_HOOD_PROBING;
+            else usage = true;
+        }
+        else if(strcmp(argv[i], "--sample") == 0 && hasValue){
+            sampleEvery = atoi(argv[++i]);
+        }
+        else{
+            usage = true;
+        }
+    }
+    if(usage || settings.keys < 0 || settings.ops < 0){
+        cout << "Usage: " << argv[0] << " [--keys N] [--seed S] [--corpus FILE] [--ops N] [--ops-file FILE]" << endl
+             << "       [--mix hit,miss,insert,delete] [--dist zipf|uniform] [--theta T] [--run]" << endl
+             << "       [--hash NAME] [--probe linear|quadratic|robinhood] [--sample N]" << endl;
+        cout << "Hash names:";
+        for(int h = 0; h < HashRegistry::count(); h++){
+            cout << " " << HashRegistry::get(h).shortName;
+        }
+        cout << endl;
+        return 1;
+    }
+    if(sampleEvery < 0) sampleEvery = 0;
+    
+    URLCorpus corpus(settings.keys, settings.seed);
+    cout << "Workload: " << settings.keys << " keys over " << corpus.getNumHosts() << " hosts, seed "
+         << settings.seed << ", " << settings.ops << " operations ("
+         << (settings.zipfian ? "Zipfian" : "uniform") << " popularity";
+    if(settings.zipfian){
+        cout << ", theta " << settings.theta;
+    }
+    cout << ")" << endl;
+    
+    if(!corpusFile.empty() && !writeCorpus(corpus, settings.keys, corpusFile)){
+        return 1;
+    }
+    if(!opsFile.empty() && !writeOps(corpus, settings, opsFile)){
+        return 1;
+    }
+    if(run){
+        runWorkload(corpus, settings, hashType, probingType, sampleEvery);
+    }
+    if(corpusFile.empty() && opsFile.empty() && !run){
+        cout << "Nothing to do: give --corpus, --ops-file or --run" << endl;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,1186 @@
+#ifndef BASICURLHASHTABLE_H
+#define BASICURLHASHTABLE_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include "HashEntry.h"
+#include "KeyArena.h"
+#include "URLKeyCodec.h"
+#include "HashFunctions.h"
+#include "SlotReducer.h"
+#include "HashPolicies.h"
+#include "Statistics.h"
+#include "OpTimer.h"
+#include "HashTypes.h"
+#include "OpResult.h"
+#include "TableObserver.h"
+#include "TableProfile.h"
+#include "URLTableEngine.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+using namespace std;
+
+// Hint that the cache line holding p is about to be read; compiles to
+// nothing where the compiler has no prefetch intrinsic
+inline void prefetchRead(const void* p){
+#if defined(__GNUC__)
+    __builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch((const char*)p, _MM_HINT_T0);
+#endif
+}
+
+// Open addressing URL table specialized at compile time on a hash policy
+// and a probe policy (see HashPolicies.h). Use it directly for the fastest
+// code path, or through the runtime-selectable URLHashTable facade
+template <typename HashPolicy, typename ProbePolicy>
+class BasicURLHashTable : public URLTableEngine {
+private:
+    vector<HashEntry> table;
+    KeyArena arena;  // Key bytes for table and oldTable
+    int size;
+    ReductionMethod reduction;
+    SlotReducer reducer;  // Hash to home slot for table
+    int numElements;
+    HashFunctions hashFunc;
+    Statistics stats;
+    OpTimer timer;
+    TableObserver* observer;
+    
+    // Incremental growth: entries drain from oldTable into table
+    double maxLoadFactor;
+    int migrateBatch;
+    vector<HashEntry> oldTable;
+    int oldSize;
+    SlotReducer oldReducer;
+    int migrateIdx;
+    
+    // DELETED slots in table (oldTable's are dropped when it drains)
+    int numTombstones;
+    double tombstoneThreshold;
+    
+    // Optional URL key encoding (arena holds encoded keys when on)
+    bool keyEncoding;
+    URLKeyCodec codec;
+    string encoded;  // Scratch buffer for the key of the current operation
+    
+    // Per-operation lookup key: hash, length and tag are computed once and
+    // checked against each occupied slot before the URL itself
+    struct ProbeKey {
+        const string* url;
+        unsigned long long hash;
+        unsigned int len;
+        unsigned int tag;
+    };
+    
+    // Batch scratch: one key per URL, and its encoded bytes when key
+    // encoding is on (encoded is shared by single operations)
+    vector<ProbeKey> batchKeys;
+    vector<string> batchEncoded;
+    vector<bool> batchAdded;  // Whether each URL's host was first interned by it
+    bool prefetch;  // Off: batches still hash up front but issue no prefetches
+    
+    const string* keyFor(const string& url, bool intern);
+    const string* keyFor(const string& url, bool intern, string& out);
+    const string* internKey(const string& url, bool& added);
+    string keyString(const HashEntry& entry);
+    ProbeKey makeKey(const string& url);
+    ProbeKey makeKey(const string& url, unsigned long long hash);
+    int locate(vector<HashEntry>& t, const SlotReducer& r, const ProbeKey& key, int& comp, int& avoided, int& avail, int& availDist);
+    int find(const ProbeKey& key, int& comp, int& avoided);
+    void insertKey(const ProbeKey& key, OpResult& result, int& avoided);
+    void prefetchBatch(const string* urls, const unsigned long long* hashes, int count, bool intern);
+    void releaseUnusedHosts(int count, const OpResult* results);
+    void robinHoodPlace(vector<HashEntry>& t, int tSize, HashEntry entry, int idx);
+    void backwardShift(vector<HashEntry>& t, int tSize, int idx);
+    void removeAt(vector<HashEntry>& t, int tSize, int idx);
+    bool placeEntry(HashEntry& entry);
+    int grownSize(int n) const;
+    void rebuild(vector<HashEntry>& pending, int newSize);
+    long reclaimKeys();
+    void startGrowth();
+    void migrateStep();
+
+public:
+    BasicURLHashTable(int tableSize);
+    ~BasicURLHashTable();
+    
+    void setMaxLoadFactor(double loadFactor);
+    void setMigrationBatch(int buckets);
+    void setTombstoneThreshold(double ratio);
+    void setKeyEncoding(bool enabled);
+    void setReduction(ReductionMethod method);
+    void setPrefetch(bool enabled);
+    bool setTimerSource(TimerSource source);
+    void setSampleInterval(int every);
+    void setObserver(TableObserver* tableObserver);
+    
+    // Silent operations with structured results
+    OpResult search(const string& url);
+    OpResult insert(const string& url);
+    OpResult remove(const string& url);
+    
+    // search that writes nothing of the table's own: statistics, timing and
+    // the encoded key go to the caller's objects. Any number of threads may
+    // run it at once as long as nothing modifies the table meanwhile
+    OpResult searchShared(const string& url, Statistics& readerStats, OpTimer& readerTimer, string& scratch);
+    
+    // Batched forms: every key is hashed and its home slot (then its key
+    // bytes) prefetched before any probe runs, so the cache misses of the
+    // whole batch overlap. results must hold count entries
+    void searchBatch(const string* urls, int count, OpResult* results);
+    void insertBatch(const string* urls, int count, OpResult* results);
+    
+    // insertBatch with each URL's HashRegistry hash64 computed by the caller
+    // (e.g. on another thread). The hashes are ignored while key encoding is
+    // on, since the stored key is then the encoded form
+    void insertBatch(const string* urls, const unsigned long long* hashes, int count, OpResult* results);
+    
+    // Same operations, reported to the attached observer
+    bool searchURL(const string& url);
+    bool insertURL(const string& url);
+    bool deleteURL(const string& url);
+    void compactTombstones();
+    
+    void displayTable();
+    void displayStats();
+    void resetStats();
+    
+    // Cluster runs, displacement and tombstones in one pass over the slots;
+    // keeps the topClusters longest runs
+    void profileTable(TableProfile& profile, int topClusters);
+    
+    double getLoadFactor();
+    int getSize();
+    int getNumElements();
+    int getNumTombstones();
+    double getTombstoneRatio();
+    bool isMigrating();
+    
+    void collectURLs(vector<string>& urls);
+    void setStats(const Statistics& statistics);
+    
+    // Get statistics
+    const Statistics& getStats() const;
+};
+
+
+template <typename HashPolicy, typename ProbePolicy>
+BasicURLHashTable<HashPolicy, ProbePolicy>::BasicURLHashTable(int tableSize){
+    size = tableSize;
+    numElements = 0;
+    table.resize(size);
+    reduction = REDUCE_MOD;
+    reducer = SlotReducer(size, reduction);
+    
+    maxLoadFactor = 0.0;
+    migrateBatch = 4;
+    oldSize = 0;
+    migrateIdx = 0;
+    
+    numTombstones = 0;
+    tombstoneThreshold = 0.2;
+    
+    keyEncoding = false;
+    prefetch = true;
+    observer = 0;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+BasicURLHashTable<HashPolicy, ProbePolicy>::~BasicURLHashTable(){}
+
+//Attach a sink for per-operation messages (not owned); 0 detaches it
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setObserver(TableObserver* tableObserver){
+    observer = tableObserver;
+}
+
+//Growth policy: once numElements would exceed loadFactor*size the table
+//doubles (see grownSize). 0 keeps the table at its constructed size
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setMaxLoadFactor(double loadFactor){
+    maxLoadFactor = loadFactor;
+}
+
+//Number of old buckets moved into the grown table per insert/delete
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setMigrationBatch(int buckets){
+    if(buckets>0){
+        migrateBatch = buckets;
+    }
+}
+
+//Compaction policy: once DELETED slots exceed this fraction of the table
+//(or deleted keys this fraction of the key arena), deleteURL cleans them
+//up in place. 0 never compacts automatically
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setTombstoneThreshold(double ratio){
+    tombstoneThreshold = ratio;
+}
+
+//Key encoding: store and hash URLs as scheme code + interned host id + the
+//rest of the URL (see URLKeyCodec). Switching on a non-empty table re-keys
+//its URLs; statistics are kept
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setKeyEncoding(bool enabled){
+    if(enabled==keyEncoding){
+        return;
+    }
+    
+    vector<string> urls;
+    collectURLs(urls);
+    Statistics saved = stats;
+    
+    table.assign(size, HashEntry());
+    vector<HashEntry>().swap(oldTable);
+    oldSize = 0;
+    migrateIdx = 0;
+    arena.clear();
+    codec = URLKeyCodec();
+    numElements = 0;
+    numTombstones = 0;
+    keyEncoding = enabled;
+    
+    for(size_t i=0; i<urls.size(); i++){
+        insert(urls[i]);
+    }
+    stats = saved;
+}
+
+//Slot reduction (see SlotReducer). REDUCE_POW2 rounds the table size up to
+//a power of two. Entries are re-placed from their stored hashes
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setReduction(ReductionMethod method){
+    reduction = method;
+    vector<HashEntry> pending;
+    rebuild(pending, method==REDUCE_POW2 ? SlotReducer::nextPowerOfTwo(size) : size);
+}
+
+//Software prefetching in searchBatch/insertBatch (on by default); switching
+//it off leaves the batched code path otherwise unchanged, for comparison
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setPrefetch(bool enabled){
+    prefetch = enabled;
+}
+
+//Clock behind the statistics' running times (see OpTimer). false if the
+//TSC was asked for but is not usable, in which case steady_clock stays
+template <typename HashPolicy, typename ProbePolicy>
+bool BasicURLHashTable<HashPolicy, ProbePolicy>::setTimerSource(TimerSource source){
+    return timer.setSource(source);
+}
+
+//Time every-th single operation (1: all, 0: none, so only batch calls are
+//timed). Probe counts are recorded for every operation regardless
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setSampleInterval(int every){
+    timer.setSampleInterval(every);
+}
+
+//The bytes stored and hashed for url: url itself, or its encoded form when
+//key encoding is on. Returns 0 if url cannot be stored (unseen host)
+template <typename HashPolicy, typename ProbePolicy>
+const string* BasicURLHashTable<HashPolicy, ProbePolicy>::keyFor(const string& url, bool intern){
+    return keyFor(url, intern, encoded);
+}
+
+//Same, encoding into out instead of the shared scratch buffer
+template <typename HashPolicy, typename ProbePolicy>
+const string* BasicURLHashTable<HashPolicy, ProbePolicy>::keyFor(const string& url, bool intern, string& out){
+    if(!keyEncoding){
+        return &url;
+    }
+    if(!codec.encode(url, out, intern)){
+        return 0;
+    }
+    return &out;
+}
+
+//The key for an insert: like keyFor, interning url's host if it is new.
+//added reports that it was, so a failed insert can release the host again
+template <typename HashPolicy, typename ProbePolicy>
+const string* BasicURLHashTable<HashPolicy, ProbePolicy>::internKey(const string& url, bool& added){
+    added = false;
+    if(!keyEncoding){
+        return &url;
+    }
+    codec.encode(url, encoded, true, added);
+    return &encoded;
+}
+
+//The URL held by an occupied entry
+template <typename HashPolicy, typename ProbePolicy>
+string BasicURLHashTable<HashPolicy, ProbePolicy>::keyString(const HashEntry& entry){
+    if(keyEncoding){
+        return codec.decode(arena.data(entry.offset), entry.len);
+    }
+    return arena.get(entry.offset, entry.len);
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+typename BasicURLHashTable<HashPolicy, ProbePolicy>::ProbeKey BasicURLHashTable<HashPolicy, ProbePolicy>::makeKey(const string& url){
+    ProbeKey key;
+    key.url = &url;
+    key.hash = HashPolicy::hash64(hashFunc, url.data(), url.size());
+    key.len = url.size();
+    key.tag = HashEntry::tailTag(url);
+    return key;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+typename BasicURLHashTable<HashPolicy, ProbePolicy>::ProbeKey BasicURLHashTable<HashPolicy, ProbePolicy>::makeKey(const string& url, unsigned long long hash){
+    ProbeKey key;
+    key.url = &url;
+    key.hash = hash;
+    key.len = url.size();
+    key.tag = HashEntry::tailTag(url);
+    return key;
+}
+
+//Walks the probe sequence of key in t. Returns the slot holding the URL or
+//-1; avail/availDist receive the slot an insert would take and its distance.
+//avoided counts occupied slots rejected without a string compare
+template <typename HashPolicy, typename ProbePolicy>
+int BasicURLHashTable<HashPolicy, ProbePolicy>::locate(vector<HashEntry>& t, const SlotReducer& r, const ProbeKey& key, int& comp, int& avoided, int& avail, int& availDist){
+    int tSize = r.getSize();
+    int idx = r.reduce(key.hash);
+    int i = 0;
+    avail = -1;
+    availDist = 0;
+    
+    while(i<tSize){
+        if(t[idx].status==EMPTY){
+            //Found empty slot - URL doesn't exist
+            if(avail == -1){
+                avail = idx;
+                availDist = i;
+            }
+            return -1;
+        }
+        
+        if(ProbePolicy::robinHood && t[idx].dist<i){
+            //Richer resident - URL doesn't exist and belongs in this slot
+            avail = idx;
+            availDist = i;
+            return -1;
+        }
+        
+        if(t[idx].status==DELETED && avail == -1){
+            // Remember first deleted slot for insertion
+            avail = idx;
+            availDist = i;
+        }
+        
+        if(t[idx].status==OCCUPIED){
+            comp++;  //Count slot comparison
+            if(t[idx].hash!=key.hash || t[idx].len!=key.len || t[idx].tag!=key.tag){
+                avoided++;
+            }
+            else if(arena.equals(t[idx].offset, *key.url)){
+                return idx;
+            }
+        }
+        
+        i++;
+        idx = ProbePolicy::next(idx, i, tSize);
+    }
+    
+    return -1;
+}
+
+//Robin Hood insertion: starting at idx, swap the carried entry with any
+//resident that is closer to its home slot ("richer")
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::robinHoodPlace(vector<HashEntry>& t, int tSize, HashEntry entry, int idx){
+    while(t[idx].status==OCCUPIED){
+        if(t[idx].dist<entry.dist){
+            swap(t[idx], entry);
+        }
+        idx = idx+1<tSize ? idx+1 : 0;
+        entry.dist++;
+    }
+    
+    t[idx] = move(entry);
+}
+
+//Backward-shift deletion: pull the following displaced entries one slot
+//back so no DELETED tombstone is needed
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::backwardShift(vector<HashEntry>& t, int tSize, int idx){
+    int next = idx+1<tSize ? idx+1 : 0;
+    
+    while(t[next].status==OCCUPIED && t[next].dist>0){
+        t[idx] = move(t[next]);
+        t[idx].dist--;
+        idx = next;
+        next = next+1<tSize ? next+1 : 0;
+    }
+    
+    t[idx] = HashEntry();
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::removeAt(vector<HashEntry>& t, int tSize, int idx){
+    arena.release(t[idx].len);
+    if(ProbePolicy::robinHood){
+        backwardShift(t, tSize, idx);
+    }
+    else{
+        t[idx].status = DELETED;
+        if(&t==&table){
+            numTombstones++;
+        }
+    }
+}
+
+//Moves an entry known to be absent into the current table. The stored hash
+//does not depend on the table size, so the key is not rehashed; entry is
+//left untouched if no slot is free
+template <typename HashPolicy, typename ProbePolicy>
+bool BasicURLHashTable<HashPolicy, ProbePolicy>::placeEntry(HashEntry& entry){
+    int home = reducer.reduce(entry.hash);
+    
+    if(ProbePolicy::robinHood){
+        entry.status = OCCUPIED;
+        entry.dist = 0;
+        robinHoodPlace(table, size, move(entry), home);
+        return true;
+    }
+    
+    int idx = home;
+    int i = 0;
+    while(i<size && table[idx].status==OCCUPIED){
+        i++;
+        idx = ProbePolicy::next(idx, i, size);
+    }
+    
+    if(i==size){
+        return false;
+    }
+    
+    if(table[idx].status==DELETED){
+        numTombstones--;
+    }
+    table[idx] = move(entry);
+    table[idx].status = OCCUPIED;
+    table[idx].dist = i;
+    return true;
+}
+
+//Size after one growth step: double, and for quadratic probing the next
+//power of two from there, the only sizes its probe sequence fully covers
+template <typename HashPolicy, typename ProbePolicy>
+int BasicURLHashTable<HashPolicy, ProbePolicy>::grownSize(int n) const{
+    if(ProbePolicy::type==QUADRATIC_PROBING){
+        return SlotReducer::nextPowerOfTwo(n*2);
+    }
+    return n*2;
+}
+
+//Places pending and every stored entry into a fresh table of newSize
+//slots at once, ending any migration. If a quadratic probe path finds no
+//free slot the table grows again and everything is placed anew, so no
+//stored entry is ever dropped
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::rebuild(vector<HashEntry>& pending, int newSize){
+    for(int i=0; i<size; i++){
+        if(table[i].status==OCCUPIED){
+            pending.push_back(move(table[i]));
+        }
+    }
+    for(int i=0; i<oldSize; i++){
+        if(oldTable[i].status==OCCUPIED){
+            pending.push_back(move(oldTable[i]));
+        }
+    }
+    vector<HashEntry>().swap(oldTable);
+    oldSize = 0;
+    migrateIdx = 0;
+    
+    while(true){
+        size = newSize;
+        reducer = SlotReducer(size, reduction);
+        table.assign(size, HashEntry());
+        numTombstones = 0;
+        
+        size_t placed = 0;
+        while(placed<pending.size() && placeEntry(pending[placed])){
+            placed++;
+        }
+        if(placed==pending.size()){
+            return;
+        }
+        
+        vector<HashEntry> retry(pending.begin()+placed, pending.end());
+        for(int i=0; i<size; i++){
+            if(table[i].status==OCCUPIED){
+                retry.push_back(move(table[i]));
+            }
+        }
+        pending.swap(retry);
+        newSize = grownSize(size);
+        stats.recordGrowth();
+    }
+}
+
+//Swaps in a larger table (see grownSize); existing entries stay in
+//oldTable and are moved over by migrateStep() a few buckets at a time
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::startGrowth(){
+    //Finish any migration still in flight before starting the next one
+    while(oldSize>0){
+        migrateStep();
+    }
+    
+    oldTable.swap(table);
+    oldSize = size;
+    oldReducer = reducer;
+    migrateIdx = 0;
+    
+    size = grownSize(size);
+    reducer = SlotReducer(size, reduction);
+    table.assign(size, HashEntry());
+    numTombstones = 0;
+    stats.recordGrowth();
+}
+
+//Repacks the arena with the keys of live entries only; returns the number
+//of bytes freed
+template <typename HashPolicy, typename ProbePolicy>
+long BasicURLHashTable<HashPolicy, ProbePolicy>::reclaimKeys(){
+    KeyArena packed;
+    packed.reserve(arena.size()-arena.getDeadBytes());
+    
+    for(int i=0; i<size; i++){
+        if(table[i].status==OCCUPIED){
+            table[i].offset = packed.append(arena.data(table[i].offset), table[i].len);
+        }
+    }
+    for(int i=0; i<oldSize; i++){
+        if(oldTable[i].status==OCCUPIED){
+            oldTable[i].offset = packed.append(arena.data(oldTable[i].offset), oldTable[i].len);
+        }
+    }
+    
+    long reclaimed = arena.size()-packed.size();
+    arena.swap(packed);
+    return reclaimed;
+}
+
+//Removes every DELETED slot without reallocating. All tombstones become
+//EMPTY and all live entries are marked DELETED ("not yet placed"); each
+//marked entry is then moved to the first free slot on its probe path,
+//swapping with any marked entry sitting there. Deleted keys' bytes are
+//then dropped from the arena
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::compactTombstones(){
+    if(oldSize>0){
+        return;  //Growth drops tombstones once the old table drains
+    }
+    
+    unsigned long long start = timer.now();
+    int removed = numTombstones;
+    
+    if(ProbePolicy::robinHood){
+        //Robin Hood never leaves tombstones, only dead key bytes
+        long reclaimed = reclaimKeys();
+        stats.recordCompaction(0, reclaimed, timer.seconds(start, timer.now()));
+        return;
+    }
+    
+    for(int i=0; i<size; i++){
+        if(table[i].status==DELETED){
+            table[i].status = EMPTY;
+        }
+        else if(table[i].status==OCCUPIED){
+            table[i].status = DELETED;
+        }
+    }
+    
+    vector<HashEntry> spill;  //Only used if a quadratic path has no free slot
+    for(int i=0; i<size; i++){
+        while(table[i].status==DELETED){
+            int idx = reducer.reduce(table[i].hash);
+            int step = 0;
+            while(step<size && table[idx].status==OCCUPIED){
+                step++;
+                idx = ProbePolicy::next(idx, step, size);
+            }
+            
+            if(step==size){
+                spill.push_back(move(table[i]));
+                table[i] = HashEntry();
+            }
+            else if(idx==i){
+                table[i].status = OCCUPIED;
+                table[i].dist = step;
+            }
+            else if(table[idx].status==EMPTY){
+                table[idx] = move(table[i]);
+                table[idx].status = OCCUPIED;
+                table[idx].dist = step;
+                table[i] = HashEntry();
+            }
+            else{
+                //Another unplaced entry: swap and keep working on slot i
+                swap(table[idx], table[i]);
+                table[idx].status = OCCUPIED;
+                table[idx].dist = step;
+            }
+        }
+    }
+    
+    numTombstones = 0;
+    size_t placed = 0;
+    while(placed<spill.size() && placeEntry(spill[placed])){
+        placed++;
+    }
+    if(placed<spill.size()){
+        //Still no slot on some path: grow rather than drop stored URLs
+        spill.erase(spill.begin(), spill.begin()+placed);
+        rebuild(spill, grownSize(size));
+    }
+    
+    long reclaimed = reclaimKeys();
+    
+    stats.recordCompaction(removed, reclaimed, timer.seconds(start, timer.now()));
+}
+
+//Moves up to migrateBatch buckets of oldTable into the current table.
+//Only inserts and deletes call this, so searchURL never writes the table
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::migrateStep(){
+    if(oldSize==0){
+        return;
+    }
+    
+    unsigned long long start = timer.now();
+    int moved = 0;
+    
+    for(int step=0; step<migrateBatch && migrateIdx<oldSize; step++){
+        HashEntry& entry = oldTable[migrateIdx];
+        if(entry.status!=OCCUPIED){
+            migrateIdx++;
+            continue;
+        }
+        
+        //Key bytes stay put in the shared arena and the stored hash is
+        //reused, so moving an entry never touches its key
+        HashEntry moving = entry;
+        if(ProbePolicy::robinHood){
+            //Backward shift may refill this bucket, so look at it again
+            backwardShift(oldTable, oldSize, migrateIdx);
+        }
+        else{
+            //Tombstone keeps the remaining old probe chains intact
+            entry.status = DELETED;
+            migrateIdx++;
+        }
+        
+        if(placeEntry(moving)){
+            moved++;
+        }
+        else{
+            //Keep the URL: place it and everything else in a larger table
+            vector<HashEntry> pending(1, moving);
+            rebuild(pending, grownSize(size));
+            break;
+        }
+    }
+    
+    if(migrateIdx>=oldSize){
+        vector<HashEntry>().swap(oldTable);
+        oldSize = 0;
+        migrateIdx = 0;
+    }
+    
+    stats.recordMigration(moved, timer.seconds(start, timer.now()));
+}
+
+//Slot holding key in the current table, or else in the table being
+//drained; -1 if neither has it
+template <typename HashPolicy, typename ProbePolicy>
+int BasicURLHashTable<HashPolicy, ProbePolicy>::find(const ProbeKey& key, int& comp, int& avoided){
+    int avail, availDist;
+    int slot = locate(table, reducer, key, comp, avoided, avail, availDist);
+    if(slot==-1 && oldSize>0){
+        slot = locate(oldTable, oldReducer, key, comp, avoided, avail, availDist);
+    }
+    return slot;
+}
+
+//Insert path shared by insert() and insertBatch(); key.url holds the bytes
+//to store
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::insertKey(const ProbeKey& key, OpResult& result, int& avoided){
+    int avail, availDist;
+    
+    migrateStep();
+    if(maxLoadFactor>0 && numElements+1>maxLoadFactor*size){
+        startGrowth();
+    }
+    
+    if(oldSize>0){
+        result.slot = locate(oldTable, oldReducer, key, result.probes, avoided, avail, availDist);
+    }
+    if(result.slot==-1){
+        result.slot = locate(table, reducer, key, result.probes, avoided, avail, availDist);
+    }
+    
+    //A quadratic path can run out of free slots below the load limit; with
+    //growth on, grow (the URL is in neither table) and look again
+    if(result.slot==-1 && avail==-1 && maxLoadFactor>0){
+        startGrowth();
+        result.slot = locate(table, reducer, key, result.probes, avoided, avail, availDist);
+    }
+    
+    // Insert URL at first available slot
+    if(result.slot==-1 && avail != -1 && numElements<size){
+        HashEntry entry;
+        entry.offset = arena.append(*key.url);
+        entry.status = OCCUPIED;
+        entry.dist = availDist;
+        entry.hash = key.hash;
+        entry.len = key.len;
+        entry.tag = key.tag;
+        
+        if(ProbePolicy::robinHood){
+            robinHoodPlace(table, size, move(entry), avail);
+        }
+        else{
+            if(table[avail].status==DELETED){
+                numTombstones--;
+            }
+            table[avail] = move(entry);
+        }
+        numElements++;
+        result.success = true;
+        result.slot = avail;
+    }
+}
+
+//Stage 1 hashes every URL and prefetches its home slot(s); stage 2, once
+//those lines are on their way, prefetches the key bytes of any home slot
+//whose stored hash matches. Keys are left in batchKeys (url 0: the host
+//was never stored). hashes, if given, replaces stage 1's hashing
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::prefetchBatch(const string* urls, const unsigned long long* hashes, int count, bool intern){
+    batchKeys.resize(count);
+    if(keyEncoding){
+        batchEncoded.resize(count);
+        batchAdded.assign(count, false);
+    }
+    
+    for(int i=0; i<count; i++){
+        bool added = false;
+        const string* key = intern ? internKey(urls[i], added) : keyFor(urls[i], false);
+        if(!key){
+            batchKeys[i].url = 0;
+            continue;
+        }
+        if(keyEncoding){
+            batchEncoded[i].swap(encoded);
+            key = &batchEncoded[i];
+            batchAdded[i] = added;
+        }
+        
+        batchKeys[i] = hashes && !keyEncoding ? makeKey(*key, hashes[i]) : makeKey(*key);
+        if(!prefetch){
+            continue;
+        }
+        prefetchRead(&table[reducer.reduce(batchKeys[i].hash)]);
+        if(oldSize>0){
+            prefetchRead(&oldTable[oldReducer.reduce(batchKeys[i].hash)]);
+        }
+    }
+    
+    for(int i=0; prefetch && i<count; i++){
+        if(!batchKeys[i].url){
+            continue;
+        }
+        const HashEntry& home = table[reducer.reduce(batchKeys[i].hash)];
+        if(home.status==OCCUPIED && home.hash==batchKeys[i].hash){
+            prefetchRead(arena.data(home.offset));
+        }
+    }
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+OpResult BasicURLHashTable<HashPolicy, ProbePolicy>::search(const string& url){
+    return searchShared(url, stats, timer, encoded);
+}
+
+//find, makeKey and a non-interning encode only read the table
+template <typename HashPolicy, typename ProbePolicy>
+OpResult BasicURLHashTable<HashPolicy, ProbePolicy>::searchShared(const string& url, Statistics& readerStats, OpTimer& readerTimer, string& scratch){
+    bool timed = readerTimer.sample();
+    unsigned long long start = timed ? readerTimer.now() : 0;
+    OpResult result;
+    int avoided = 0;
+    const string* key = keyFor(url, false, scratch);  //0: host never stored
+    
+    if(key){
+        result.slot = find(makeKey(*key), result.probes, avoided);
+    }
+    result.success = result.slot!=-1;
+    
+    OpKind kind = result.success ? OP_SEARCH_HIT : OP_SEARCH_MISS;
+    if(timed){
+        result.elapsed = readerTimer.seconds(start, readerTimer.now());
+        readerStats.recordTime(kind, result.elapsed);
+    }
+    readerStats.recordQuery(kind, result.probes);
+    readerStats.recordAvoidedCompares(avoided);
+    return result;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+OpResult BasicURLHashTable<HashPolicy, ProbePolicy>::insert(const string& url){
+    bool timed = timer.sample();
+    unsigned long long start = timed ? timer.now() : 0;
+    OpResult result;
+    int avoided = 0;
+    
+    //A host is kept only once a key that uses it is stored
+    bool added;
+    const string* key = internKey(url, added);
+    insertKey(makeKey(*key), result, avoided);
+    unsigned int hostId;
+    if(added && !result.success && URLKeyCodec::hostId(key->data(), key->size(), hostId)){
+        codec.release(hostId);
+    }
+    
+    if(timed){
+        result.elapsed = timer.seconds(start, timer.now());
+        stats.recordTime(OP_INSERT, result.elapsed);
+    }
+    stats.recordQuery(OP_INSERT, result.probes);
+    stats.recordAvoidedCompares(avoided);
+    return result;
+}
+
+//The batch is timed as one interval, whatever the sample interval; each
+//result gets an equal share
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::searchBatch(const string* urls, int count, OpResult* results){
+    if(count<=0){
+        return;
+    }
+    
+    unsigned long long start = timer.now();
+    int avoided = 0;
+    
+    prefetchBatch(urls, 0, count, false);
+    for(int i=0; i<count; i++){
+        results[i] = OpResult();
+        if(batchKeys[i].url){
+            results[i].slot = find(batchKeys[i], results[i].probes, avoided);
+        }
+        results[i].success = results[i].slot!=-1;
+    }
+    
+    double seconds = timer.seconds(start, timer.now());
+    stats.recordBatchTime(seconds, count);
+    for(int i=0; i<count; i++){
+        stats.recordQuery(results[i].success ? OP_SEARCH_HIT : OP_SEARCH_MISS, results[i].probes);
+        results[i].elapsed = seconds/count;
+    }
+    stats.recordAvoidedCompares(avoided);
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::insertBatch(const string* urls, int count, OpResult* results){
+    insertBatch(urls, 0, count, results);
+}
+
+//A host first interned by a failed insert of the batch is released unless a
+//later insert of the batch stored a key with it
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::releaseUnusedHosts(int count, const OpResult* results){
+    vector<unsigned int> unused;
+    unsigned int id;
+    for(int i=0; i<count; i++){
+        const string& key = *batchKeys[i].url;
+        if(batchAdded[i] && !results[i].success && URLKeyCodec::hostId(key.data(), key.size(), id)){
+            unused.push_back(id);
+        }
+    }
+    
+    for(int i=0; i<count && !unused.empty(); i++){
+        const string& key = *batchKeys[i].url;
+        if(results[i].success && URLKeyCodec::hostId(key.data(), key.size(), id)){
+            unused.erase(std::remove(unused.begin(), unused.end(), id), unused.end());
+        }
+    }
+    
+    for(size_t i=0; i<unused.size(); i++){
+        codec.release(unused[i]);
+    }
+}
+
+//Inserts run in order, so duplicates within the batch behave as they would
+//one at a time. Growth mid-batch only makes the remaining prefetches stale
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::insertBatch(const string* urls, const unsigned long long* hashes, int count, OpResult* results){
+    if(count<=0){
+        return;
+    }
+    
+    unsigned long long start = timer.now();
+    int avoided = 0;
+    
+    prefetchBatch(urls, hashes, count, true);
+    for(int i=0; i<count; i++){
+        results[i] = OpResult();
+        insertKey(batchKeys[i], results[i], avoided);
+    }
+    if(keyEncoding){
+        releaseUnusedHosts(count, results);
+    }
+    
+    double seconds = timer.seconds(start, timer.now());
+    stats.recordBatchTime(seconds, count);
+    for(int i=0; i<count; i++){
+        stats.recordQuery(OP_INSERT, results[i].probes);
+        results[i].elapsed = seconds/count;
+    }
+    stats.recordAvoidedCompares(avoided);
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+OpResult BasicURLHashTable<HashPolicy, ProbePolicy>::remove(const string& url){
+    bool timed = timer.sample();
+    unsigned long long start = timed ? timer.now() : 0;
+    OpResult result;
+    int avail, availDist;
+    
+    int avoided = 0;
+    
+    migrateStep();
+    
+    const string* key = keyFor(url, false);  //0: host never stored
+    ProbeKey probeKey;
+    if(key){
+        probeKey = makeKey(*key);
+        result.slot = locate(table, reducer, probeKey, result.probes, avoided, avail, availDist);
+    }
+    if(result.slot!=-1){
+        removeAt(table, size, result.slot);
+    }
+    else if(key && oldSize>0){
+        result.slot = locate(oldTable, oldReducer, probeKey, result.probes, avoided, avail, availDist);
+        if(result.slot!=-1){
+            removeAt(oldTable, oldSize, result.slot);
+        }
+    }
+    
+    if(result.slot!=-1){
+        numElements--;
+        result.success = true;
+    }
+    
+    if(timed){
+        result.elapsed = timer.seconds(start, timer.now());
+        stats.recordTime(OP_DELETE, result.elapsed);
+    }
+    stats.recordQuery(OP_DELETE, result.probes);
+    stats.recordAvoidedCompares(avoided);
+    
+    if(tombstoneThreshold>0 && (numTombstones>tombstoneThreshold*size ||
+                                arena.getDeadBytes()>tombstoneThreshold*arena.size())){
+        compactTombstones();
+    }
+    
+    return result;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+bool BasicURLHashTable<HashPolicy, ProbePolicy>::searchURL(const string& url){
+    OpResult result = search(url);
+    if(observer){
+        observer->onSearch(url, result);
+    }
+    return result.success;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+bool BasicURLHashTable<HashPolicy, ProbePolicy>::insertURL(const string& url){
+    OpResult result = insert(url);
+    if(observer){
+        observer->onInsert(url, result);
+    }
+    return result.success;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+bool BasicURLHashTable<HashPolicy, ProbePolicy>::deleteURL(const string& url){
+    OpResult result = remove(url);
+    if(observer){
+        observer->onDelete(url, result);
+    }
+    return result.success;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::displayTable(){
+    cout << "\nHash Table Contents" << endl;
+    for(int i=0; i<size; i++){
+        cout << "Slot[" << i << "]: ";
+        if(table[i].status==OCCUPIED){
+            cout << keyString(table[i]);
+        }
+        else if(table[i].status==DELETED){
+            cout << "[DELETED]";
+        }
+        else{
+            cout << "[EMPTY]";
+        }
+        cout << endl;
+    }
+    
+    if(oldSize>0){
+        cout << "\nNot Yet Migrated (previous table)" << endl;
+        for(int i=migrateIdx; i<oldSize; i++){
+            if(oldTable[i].status==OCCUPIED){
+                cout << "Old Slot[" << i << "]: " << keyString(oldTable[i]) << endl;
+            }
+        }
+    }
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::profileTable(TableProfile& profile, int topClusters){
+    profile.begin(size, topClusters);
+    for(int i=0; i<size; i++){
+        profile.slot(i, table[i].status, table[i].dist);
+    }
+    profile.finish();
+    
+    //Entries not yet migrated are counted but not laid out
+    for(int i=migrateIdx; i<oldSize; i++){
+        if(oldTable[i].status==OCCUPIED){
+            profile.pendingMigration++;
+        }
+    }
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::displayStats(){
+    cout << "HASH STATS" << endl;
+    
+    cout << "\nConfiguration:" << endl;
+    cout << "Hash Function: " << HashPolicy::name() << endl;
+    cout << "Probing Method: " << ProbePolicy::name() << endl;
+    
+    cout << "Growth Policy: ";
+    if(maxLoadFactor>0){
+        cout << "double when load factor exceeds " << maxLoadFactor
+             << " (" << migrateBatch << " buckets migrated per operation)" << endl;
+    }
+    else{
+        cout << "Fixed size" << endl;
+    }
+    
+    cout << "Slot Reduction: " << SlotReducer::methodName(reduction) << endl;
+    
+    cout << "Key Encoding: ";
+    if(keyEncoding){
+        cout << "scheme code + interned host (" << codec.getNumHosts() << " hosts, "
+             << codec.getMemoryBytes() << " bytes)" << endl;
+    }
+    else{
+        cout << "Off" << endl;
+    }
+    
+    stats.display(size, numElements, getLoadFactor(), HashPolicy::type);
+    stats.displayCompares();
+    stats.displayPercentiles();
+    stats.displayTombstones(numTombstones, size, tombstoneThreshold);
+    
+    //Same slots holding the plain URL in a std::string instead of an arena
+    //offset, for comparison: the string object plus a heap buffer past SSO
+    long slotBytes = (long)(size+oldSize)*sizeof(HashEntry);
+    long stringBytes = (long)(size+oldSize)*(sizeof(HashEntry)-sizeof(size_t)+sizeof(string));
+    size_t inlineCapacity = string().capacity();
+    for(int i=0; i<size+oldSize; i++){
+        const HashEntry& entry = i<size ? table[i] : oldTable[i-size];
+        if(entry.status==OCCUPIED){
+            size_t urlLen = keyEncoding ? keyString(entry).size() : entry.len;
+            if(urlLen>inlineCapacity){
+                stringBytes += urlLen+1;
+            }
+        }
+    }
+    long keyBytes = arena.capacity()+codec.getMemoryBytes();
+    stats.displayKeyStorage(numElements, slotBytes, keyBytes, arena.getDeadBytes(), stringBytes);
+    
+    stats.displayMigration(migrateIdx, oldSize);
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::resetStats(){
+    stats.reset();
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+double BasicURLHashTable<HashPolicy, ProbePolicy>::getLoadFactor(){
+    return (double)numElements/size;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+int BasicURLHashTable<HashPolicy, ProbePolicy>::getSize(){
+    return size;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+int BasicURLHashTable<HashPolicy, ProbePolicy>::getNumElements(){
+    return numElements;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+int BasicURLHashTable<HashPolicy, ProbePolicy>::getNumTombstones(){
+    return numTombstones;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+double BasicURLHashTable<HashPolicy, ProbePolicy>::getTombstoneRatio(){
+    return (double)numTombstones/size;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+bool BasicURLHashTable<HashPolicy, ProbePolicy>::isMigrating(){
+    return oldSize>0;
+}
+
+//Every live URL, including those still waiting in the draining table
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::collectURLs(vector<string>& urls){
+    for(int i=0; i<size; i++){
+        if(table[i].status==OCCUPIED){
+            urls.push_back(keyString(table[i]));
+        }
+    }
+    for(int i=migrateIdx; i<oldSize; i++){
+        if(oldTable[i].status==OCCUPIED){
+            urls.push_back(keyString(oldTable[i]));
+        }
+    }
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+void BasicURLHashTable<HashPolicy, ProbePolicy>::setStats(const Statistics& statistics){
+    stats = statistics;
+}
+
+template <typename HashPolicy, typename ProbePolicy>
+const Statistics& BasicURLHashTable<HashPolicy, ProbePolicy>::getStats() const{
+    return stats;
+}
+
+#endif
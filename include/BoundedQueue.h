@@ -0,0 +1,90 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+// Blocking FIFO of at most capacity items between two pipeline stages. A
+// full queue stalls the producer, so memory in flight stays bounded however
+// fast the producer is. close() marks the end of the stream: pop() drains
+// what is left and then returns false.
+// Occupancy is sampled at every push, and waits on a full or empty queue
+// are counted, to show which side of the queue is the bottleneck (read
+// them once both sides have finished)
+template <typename T>
+class BoundedQueue {
+private:
+    deque<T> items;
+    size_t capacity;
+    bool closed;
+    mutex lock;
+    condition_variable notEmpty;
+    condition_variable notFull;
+    
+    long pushes;
+    long occupancySum;  // Items queued after each push, summed
+    size_t maxOccupancy;
+    long fullWaits;     // Pushes that found the queue full
+    long emptyWaits;    // Pops that found the queue empty and open
+
+public:
+    BoundedQueue(size_t maxItems) : capacity(maxItems>0 ? maxItems : 1), closed(false),
+        pushes(0), occupancySum(0), maxOccupancy(0), fullWaits(0), emptyWaits(0) {}
+    
+    void push(T item){
+        unique_lock<mutex> guard(lock);
+        if(items.size()>=capacity){
+            fullWaits++;
+            notFull.wait(guard, [this]() { return items.size()<capacity; });
+        }
+        items.push_back(move(item));
+        
+        pushes++;
+        occupancySum += items.size();
+        if(items.size()>maxOccupancy){
+            maxOccupancy = items.size();
+        }
+        guard.unlock();
+        notEmpty.notify_one();
+    }
+    
+    // false once the queue is closed and empty
+    bool pop(T& item){
+        unique_lock<mutex> guard(lock);
+        if(items.empty() && !closed){
+            emptyWaits++;
+            notEmpty.wait(guard, [this]() { return !items.empty() || closed; });
+        }
+        if(items.empty()){
+            return false;
+        }
+        item = move(items.front());
+        items.pop_front();
+        guard.unlock();
+        notFull.notify_one();
+        return true;
+    }
+    
+    // No more pushes; wakes every waiting consumer
+    void close(){
+        {
+            lock_guard<mutex> guard(lock);
+            closed = true;
+        }
+        notEmpty.notify_all();
+    }
+    
+    size_t getCapacity() const{ return capacity; }
+    long getPushes() const{ return pushes; }
+    size_t getMaxOccupancy() const{ return maxOccupancy; }
+    long getFullWaits() const{ return fullWaits; }
+    long getEmptyWaits() const{ return emptyWaits; }
+    
+    double getAvgOccupancy() const{
+        return pushes>0 ? (double)occupancySum/pushes : 0.0;
+    }
+};
+
+#endif
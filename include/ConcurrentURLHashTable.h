@@ -0,0 +1,101 @@
+#ifndef CONCURRENTURLHASHTABLE_H
+#define CONCURRENTURLHASHTABLE_H
+
+#include <string>
+#include <atomic>
+#include "HashFunctions.h"
+#include "HashRegistry.h"
+#include "SlotReducer.h"
+#include "EpochReclaimer.h"
+#include "Statistics.h"
+#include "OpTimer.h"
+#include "HashTypes.h"
+#include "OpResult.h"
+#include "TableObserver.h"
+
+using namespace std;
+
+// Lock-free linear probing table for concurrent inserts, searches and
+// deletes. Each slot is one atomic pointer that holds the slot state and
+// the key together: null is EMPTY, a marker node is DELETED, anything else
+// is the OCCUPIED key (its hash, length and bytes in one allocation).
+// Inserts claim an EMPTY slot with a single CAS; deletes CAS the key to the
+// DELETED marker and retire it to an EpochReclaimer, so readers still
+// holding it never see freed memory.
+//
+// Slots only ever go EMPTY -> key -> DELETED, so two inserts of the same
+// URL always race for the same first EMPTY slot and the loser sees the
+// winner's key. The price is that DELETED slots are not reused until
+// compactTombstones() runs, and the table does not grow. Functions marked
+// "quiescent" must not run alongside any other operation on the table
+class ConcurrentURLHashTable {
+private:
+    struct KeyNode {
+        unsigned long long hash;
+        unsigned int len;
+        char bytes[1];  // len bytes, allocated with the node
+    };
+    
+    // Per-thread counters and timer (indexed by EpochReclaimer::threadIndex),
+    // so the hot path never writes a cache line another thread is writing
+    struct ThreadStats {
+        Statistics stats;
+        OpTimer timer;
+        atomic<long> inserted;
+        atomic<long> removed;
+        char pad[64];
+    };
+    
+    atomic<KeyNode*>* slots;
+    int size;
+    SlotReducer reducer;
+    HashFunctions hashFunc;
+    HashType current_hType;
+    const HashAlgorithm* hashAlgo;
+    EpochReclaimer reclaimer;
+    ThreadStats* threadStats;
+    long removedAtCompaction;  // Sum of removed when tombstones were last cleared
+    TableObserver* observer;
+    
+    static KeyNode* makeNode(const string& url, unsigned long long hash);
+    static void freeNode(void* node);
+    bool matches(const KeyNode* node, const string& url, unsigned long long hash, int& avoided) const;
+    void placeAll(bool rehash);
+
+public:
+    ConcurrentURLHashTable(int tableSize);
+    ~ConcurrentURLHashTable();
+    
+    void setHashFunction(HashType hashType);  // Quiescent
+    bool setTimerSource(TimerSource source);  // Quiescent
+    void setSampleInterval(int every);        // Quiescent; counted per thread
+    void setObserver(TableObserver* tableObserver);
+    
+    // Silent operations with structured results; safe from any thread
+    OpResult search(const string& url);
+    OpResult insert(const string& url);
+    OpResult remove(const string& url);
+    
+    // Same operations, reported to the attached observer
+    bool searchURL(const string& url);
+    bool insertURL(const string& url);
+    bool deleteURL(const string& url);
+    
+    // Re-places every key from its stored hash so DELETED slots become
+    // EMPTY again, and frees every retired key. Quiescent
+    void compactTombstones();
+    
+    void displayStats();  // Quiescent
+    void resetStats();    // Quiescent
+    
+    double getLoadFactor();
+    int getSize();
+    int getNumElements();
+    int getNumTombstones();
+    long getPendingReclaim() const;
+    
+    // Merged over all threads. Quiescent
+    Statistics getStats();
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef CUCKOOHASHTABLE_H
+#define CUCKOOHASHTABLE_H
+
+#include <vector>
+#include <string>
+#include "KeyArena.h"
+#include "HashFunctions.h"
+#include "HashRegistry.h"
+#include "SlotReducer.h"
+#include "Statistics.h"
+#include "OpTimer.h"
+#include "HashTypes.h"
+#include "OpResult.h"
+#include "TableObserver.h"
+
+using namespace std;
+
+//Bucketized cuckoo engine: every URL lives in one of two 4-slot buckets
+//chosen by two independent hashes. A bucket is one cache-line-aligned
+//struct holding its slots' fingerprints, key references and other
+//buckets; the key bytes live in a KeyArena. A lookup therefore reads at
+//most two bucket lines whatever the load, plus the key bytes of slots
+//whose fingerprint matches. A full pair of buckets is resolved on insert
+//by a breadth-first search for the shortest chain of entries to move to
+//their other bucket
+class CuckooHashTable {
+private:
+    static const int BUCKET_SLOTS = 4;
+    static const int MAX_SEARCH_BUCKETS = 512;  // BFS limit before an insert fails
+    static const unsigned char TAG_EMPTY = 0;
+    static const int CACHE_LINE = 64;
+    
+    // A slot's key is its arena offset and length packed into 64 bits:
+    // offsets up to 2^40 bytes, keys up to MAX_KEY_LENGTH bytes
+    static const int KEY_LENGTH_BITS = 24;
+    static const unsigned long long MAX_KEY_LENGTH = (1ULL << KEY_LENGTH_BITS) - 1;
+    
+    // 56 bytes of slots, padded to exactly one cache line
+    struct alignas(CACHE_LINE) Bucket {
+        unsigned char tags[BUCKET_SLOTS];       // 8-bit fingerprint per slot, TAG_EMPTY if free
+        int alt[BUCKET_SLOTS];                  // Each entry's other candidate bucket
+        unsigned long long keys[BUCKET_SLOTS];  // Arena offset << KEY_LENGTH_BITS | length
+    };
+    
+    //One bucket reached by the BFS: entry slot of parent moves into bucket
+    struct PathNode {
+        int bucket;
+        int parent;  // Index in the search queue, -1 for the new URL's buckets
+        int slot;    // Slot of the parent bucket whose entry moves here
+        int depth;
+    };
+    
+    char* bucketMemory;  // Allocation holding the aligned bucket array
+    Bucket* buckets;
+    KeyArena arena;
+    int numBuckets;
+    SlotReducer bucketReducer;
+    int size;
+    int numElements;
+    long long relocations;  // Entries moved to their other bucket
+    int longestPath;
+    long failedInserts;
+    vector<PathNode> queue;  // BFS scratch, reused between inserts
+    HashFunctions hashFunc;
+    Statistics stats;
+    OpTimer timer;
+    HashType current_hType;
+    const HashAlgorithm* hashAlgo;    // First hash: registry entry for current_hType
+    const HashAlgorithm* secondAlgo;  // Second hash, from another HashFunctions family
+    TableObserver* observer;
+    
+    void hashURL(const string& url, int& first, int& second, unsigned char& tag);
+    int findInBucket(int bucket, const string& url, unsigned char tag, int& comp) const;
+    int findSlot(const string& url, int first, int second, unsigned char tag, int& comp) const;
+    int freeSlot(int bucket) const;
+    bool onPath(int node, int bucket) const;
+    int makeRoom(int first, int second);
+    void place(int idx, const string& url, unsigned char tag, int other);
+    void reclaimKeys();
+    
+    static size_t keyOffset(unsigned long long key){ return (size_t)(key >> KEY_LENGTH_BITS); }
+    static unsigned int keyLength(unsigned long long key){ return (unsigned int)(key & MAX_KEY_LENGTH); }
+    
+    // The bucket array is owned through a raw pointer
+    CuckooHashTable(const CuckooHashTable&);
+    CuckooHashTable& operator=(const CuckooHashTable&);
+
+public:
+    CuckooHashTable(int tableSize);
+    ~CuckooHashTable();
+    
+    void setHashFunction(HashType hashType);
+    bool setTimerSource(TimerSource source);
+    void setSampleInterval(int every);  // 0: operations are not timed
+    void setObserver(TableObserver* tableObserver);
+    
+    // Silent operations with structured results
+    OpResult search(const string& url);
+    OpResult insert(const string& url);
+    OpResult remove(const string& url);
+    
+    // Same operations, reported to the attached observer
+    bool searchURL(const string& url);
+    bool insertURL(const string& url);
+    bool deleteURL(const string& url);
+    
+    void displayStats();
+    void resetStats();
+    
+    double getLoadFactor();
+    int getSize();
+    int getNumElements();
+    long long getRelocations() const;
+    int getLongestPath() const;  // Most entries moved by one insert
+    long getFailedInserts() const;  // Includes URLs longer than MAX_KEY_LENGTH
+    
+    // Get statistics
+    const Statistics& getStats() const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef EPOCHRECLAIMER_H
+#define EPOCHRECLAIMER_H
+
+#include <vector>
+#include <atomic>
+using namespace std;
+
+// Epoch-based reclamation for lock-free readers. A thread brackets every
+// access to shared nodes with enter()/exit(); a node unlinked from the
+// structure is handed to retire() and only freed once the global epoch has
+// advanced twice, by which point no thread can still be reading it.
+// Threads are identified by threadIndex(), a small id reused after a thread
+// exits; at most MAX_THREADS threads may hold one at the same time
+class EpochReclaimer {
+public:
+    static const int MAX_THREADS = 256;
+    typedef void (*Deleter)(void*);
+
+private:
+    struct Retired {
+        void* node;
+        Deleter deleter;
+        unsigned long long epoch;  // Global epoch when the node was retired
+    };
+    
+    // One per thread index, touched by other threads only through state
+    struct Record {
+        atomic<unsigned long long> state;  // (epoch << 1) | inside critical section
+        vector<Retired> limbo;
+        char pad[64];
+    };
+    
+    atomic<unsigned long long> globalEpoch;
+    Record* records;
+    atomic<long> numRetired;
+    atomic<long> numFreed;
+    
+    bool tryAdvance();
+    void reclaim(Record& record, unsigned long long epoch);
+
+public:
+    EpochReclaimer();
+    ~EpochReclaimer();  // Frees every pending node
+    
+    void enter();
+    void exit();
+    
+    // Called inside enter()/exit(), after node is unreachable for new readers
+    void retire(void* node, Deleter deleter);
+    
+    // Frees every pending node; only while no thread is between enter/exit
+    void drain();
+    
+    long getPending() const;
+    long getFreed() const;
+    unsigned long long getEpoch() const;
+    
+    static int threadIndex();
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef FASTHASHES_H
+#define FASTHASHES_H
+
+#include <cstddef>
+using namespace std;
+
+// Well-known non-cryptographic hashes over raw key bytes. Each returns its
+// full-width value (CRC32C fills only the low 32 bits); callers reduce it to
+// a table index. Multi-byte reads are little-endian, as in the references
+class FastHashes {
+private:
+    static unsigned int crc32cHardware(const char* key, size_t len, unsigned int crc);
+
+public:
+    static unsigned long long xxHash64(const char* key, size_t len, unsigned long long seed);
+    static unsigned long long wyhash(const char* key, size_t len, unsigned long long seed);
+    static unsigned long long fnv1a64(const char* key, size_t len, unsigned long long seed);
+    
+    // Low 64 bits of MurmurHash3_x64_128
+    static unsigned long long murmur3(const char* key, size_t len, unsigned long long seed);
+    
+    // CRC32C (Castagnoli). Uses the SSE4.2 crc32 instruction when the CPU has
+    // it and a slicing-by-8 table otherwise; both give the same value.
+    // crc32cSoftware is the raw table update, without the ~ before and after
+    static unsigned long long crc32c(const char* key, size_t len, unsigned long long seed);
+    static unsigned int crc32cSoftware(const char* key, size_t len, unsigned int crc);
+    
+    // Hardware CRC32C can be switched off (e.g. for benchmarks); turning it
+    // on fails if the CPU lacks SSE4.2
+    static bool crc32cHardwareSupported();
+    static bool crc32cHardwareEnabled();
+    static bool setCrc32cHardware(bool enabled);
+};
+
+#endif
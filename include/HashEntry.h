@@ -7,10 +7,22 @@ using namespace std;
 
 class HashEntry {
 public:
-    string url;
+    size_t offset;       // Key bytes in the owning table's KeyArena
+    
+    // Checked before the key bytes so most mismatches never touch the arena;
+    // hash also lets compaction and growth re-place the entry without
+    // rehashing its key
+    unsigned long long hash;  // Full 64-bit hash, independent of table size
+    unsigned int len;    // URL length
+    unsigned int tag;    // Last (up to) 4 bytes of the URL
     SlotStatus status;
+    int dist;            // Probe distance from the home slot
     
     HashEntry();
+    
+    // URLs tend to share their leading bytes ("http://www."), so the tag is
+    // taken from the end of the string
+    static unsigned int tailTag(const string& url);
 };
 
 #endif
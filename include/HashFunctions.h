@@ -4,17 +4,83 @@
 #include <string>
 using namespace std;
 
+// Block kernel behind the *WideHash functions. Every kernel returns the same
+// values; they only differ in how many bytes one instruction handles
+enum HashKernel { KERNEL_SCALAR, KERNEL_SSE41, KERNEL_AVX2 };
+
 class HashFunctions {
 private:
     unsigned long k;  // Large odd number
     unsigned long a;  // Random value for universal hashing
     unsigned long b;  // Random value for universal hashing
     
+    // Powers of a hash's base for one 32-byte block: pw[j] = base^(31-j)
+    // and pwRun[r] = base^r, reduced mod modulus (0 meaning mod 2^64)
+    struct PowerTable {
+        unsigned long long modulus;
+        unsigned long long pw[32];
+        unsigned long long pwRun[33];
+    };
+    PowerTable bitwisePowers;
+    PowerTable polyPowers;       // Rebuilt when the table size changes
+    PowerTable universalPowers;  // Rebuilt when k*size changes
+    
+    // Same layout for the mod 2^61-1 hashes. Powers are split into their low
+    // 32 bits and the rest so the kernels' 32-bit multiplies can take them
+    struct MersennePowers {
+        unsigned long long pwLo[32];
+        unsigned long long pwHi[32];
+        unsigned long long pwRun[33];
+    };
+    MersennePowers polyPowers61;
+    MersennePowers universalPowers61;
+    unsigned long long a61;  // Random values for universalHash64, below 2^61-1
+    unsigned long long b61;
+    
+    static void buildPowers(PowerTable& t, unsigned long long base, unsigned long long modulus);
+    static void buildPowers61(MersennePowers& t, unsigned long long base);
+    static unsigned long long blockRecurrence(const char* key, size_t len, const PowerTable& t);
+    static unsigned long long blockRecurrence61(const char* key, size_t len, const MersennePowers& t);
+    
 public:
     HashFunctions();
     unsigned long bitwiseHash(const string& url, int size);
     unsigned long polynomialHash(const string& url, int size);
     unsigned long universalHash(const string& url, int size);
+    
+    // Same hashes over raw key bytes (e.g. a key stored in a KeyArena)
+    unsigned long bitwiseHash(const char* key, size_t len, int size);
+    unsigned long polynomialHash(const char* key, size_t len, int size);
+    unsigned long universalHash(const char* key, size_t len, int size);
+    
+    // Wide variants: identical results, but the per-byte recurrence is
+    // evaluated 32 bytes at a time as a dot product with precomputed powers,
+    // so there is no serial chain and at most one % per block
+    unsigned long bitwiseWideHash(const string& url, int size);
+    unsigned long polynomialWideHash(const string& url, int size);
+    unsigned long universalWideHash(const string& url, int size);
+    unsigned long bitwiseWideHash(const char* key, size_t len, int size);
+    unsigned long polynomialWideHash(const char* key, size_t len, int size);
+    unsigned long universalWideHash(const char* key, size_t len, int size);
+    
+    // Size-independent 64-bit forms, reduced to a slot by SlotReducer.
+    // bitwiseHash64 % size equals bitwiseHash; the polynomial and universal
+    // forms keep their formulas but work mod the prime 2^61-1 instead of the
+    // table size (no division per byte), then multiply by 2^64/phi so the
+    // high bits are mixed as well as the low ones
+    unsigned long long bitwiseHash64(const char* key, size_t len);
+    unsigned long long polynomialHash64(const char* key, size_t len);
+    unsigned long long universalHash64(const char* key, size_t len);
+    unsigned long long bitwiseWideHash64(const char* key, size_t len);
+    unsigned long long polynomialWideHash64(const char* key, size_t len);
+    unsigned long long universalWideHash64(const char* key, size_t len);
+    
+    // Kernel selection: the best one the CPU supports is picked at startup;
+    // setKernel overrides it (e.g. for benchmarks) if the CPU supports it
+    static HashKernel getKernel();
+    static bool setKernel(HashKernel kernel);
+    static bool kernelSupported(HashKernel kernel);
+    static const char* kernelName(HashKernel kernel);
 };
 
 #endif
@@ -0,0 +1,146 @@
+#ifndef HASHPOLICIES_H
+#define HASHPOLICIES_H
+
+#include <string>
+#include "HashFunctions.h"
+#include "FastHashes.h"
+#include "HashTypes.h"
+using namespace std;
+
+// Compile-time hash and probe policies for BasicURLHashTable. Each one is a
+// stateless struct of inline static functions, so the table's probe loop is
+// specialized per configuration instead of branching on every step.
+// Hash policies return a size-independent 64-bit hash (see SlotReducer);
+// probe policies step from one slot to the next without a division
+
+struct BitwiseHashPolicy {
+    static const HashType type = BITWISE_HASH;
+    static const char* name(){ return "Bitwise Mixing Hash"; }
+    static unsigned long long hash64(HashFunctions& f, const char* key, size_t len){
+        return f.bitwiseHash64(key, len);
+    }
+};
+
+struct PolynomialHashPolicy {
+    static const HashType type = POLYNOMIAL_HASH;
+    static const char* name(){ return "Polynomial Rolling Hash"; }
+    static unsigned long long hash64(HashFunctions& f, const char* key, size_t len){
+        return f.polynomialHash64(key, len);
+    }
+};
+
+struct UniversalHashPolicy {
+    static const HashType type = UNIVERSAL_HASH;
+    static const char* name(){ return "Universal Hashing"; }
+    static unsigned long long hash64(HashFunctions& f, const char* key, size_t len){
+        return f.universalHash64(key, len);
+    }
+};
+
+// Same hash values as the three above, computed by the block kernels
+struct BitwiseWideHashPolicy {
+    static const HashType type = BITWISE_WIDE_HASH;
+    static const char* name(){ return "Bitwise Mixing Hash (wide kernel)"; }
+    static unsigned long long hash64(HashFunctions& f, const char* key, size_t len){
+        return f.bitwiseWideHash64(key, len);
+    }
+};
+
+struct PolynomialWideHashPolicy {
+    static const HashType type = POLYNOMIAL_WIDE_HASH;
+    static const char* name(){ return "Polynomial Rolling Hash (wide kernel)"; }
+    static unsigned long long hash64(HashFunctions& f, const char* key, size_t len){
+        return f.polynomialWideHash64(key, len);
+    }
+};
+
+struct UniversalWideHashPolicy {
+    static const HashType type = UNIVERSAL_WIDE_HASH;
+    static const char* name(){ return "Universal Hashing (wide kernel)"; }
+    static unsigned long long hash64(HashFunctions& f, const char* key, size_t len){
+        return f.universalWideHash64(key, len);
+    }
+};
+
+// Well-known hashes from FastHashes (seed 0)
+struct XXHash64HashPolicy {
+    static const HashType type = XXHASH64_HASH;
+    static const char* name(){ return "xxHash64"; }
+    static unsigned long long hash64(HashFunctions&, const char* key, size_t len){
+        return FastHashes::xxHash64(key, len, 0);
+    }
+};
+
+struct WyhashHashPolicy {
+    static const HashType type = WYHASH_HASH;
+    static const char* name(){ return "wyhash"; }
+    static unsigned long long hash64(HashFunctions&, const char* key, size_t len){
+        return FastHashes::wyhash(key, len, 0);
+    }
+};
+
+struct Fnv1aHashPolicy {
+    static const HashType type = FNV1A_HASH;
+    static const char* name(){ return "FNV-1a (64-bit)"; }
+    static unsigned long long hash64(HashFunctions&, const char* key, size_t len){
+        return FastHashes::fnv1a64(key, len, 0);
+    }
+};
+
+struct Murmur3HashPolicy {
+    static const HashType type = MURMUR3_HASH;
+    static const char* name(){ return "MurmurHash3 (x64)"; }
+    static unsigned long long hash64(HashFunctions&, const char* key, size_t len){
+        return FastHashes::murmur3(key, len, 0);
+    }
+};
+
+struct Crc32cHashPolicy {
+    static const HashType type = CRC32C_HASH;
+    static const char* name(){ return "CRC32C"; }
+    static unsigned long long hash64(HashFunctions&, const char* key, size_t len){
+        //32-bit CRC spread over 64 bits like the mod 2^61-1 hashes
+        return FastHashes::crc32c(key, len, 0) * 0x9E3779B97F4A7C15ULL;
+    }
+};
+
+struct LinearProbePolicy {
+    static const ProbingMethod type = LINEAR_PROBING;
+    static const bool robinHood = false;
+    static const char* name(){ return "Linear Probing"; }
+    // Slot for step i given the slot for step i-1
+    static int next(int idx, int, int size){
+        return idx+1<size ? idx+1 : 0;
+    }
+};
+
+struct QuadraticProbePolicy {
+    static const ProbingMethod type = QUADRATIC_PROBING;
+    static const bool robinHood = false;
+    static const char* name(){ return "Quadratic Probing"; }
+    // home+i*i is home+(i-1)*(i-1) plus 2i-1; with i at most size both
+    // additions wrap at most once. i*i mod 2^k reaches only a few slots, so
+    // power-of-two tables step by i instead (home+i(i+1)/2), which visits
+    // every slot; the grown table is always one (see BasicURLHashTable)
+    static int next(int idx, int i, int size){
+        int step = (size&(size-1))==0 ? i : 2*i-1;
+        if(step>=size){
+            step -= size;
+        }
+        idx += step;
+        return idx>=size ? idx-size : idx;
+    }
+};
+
+// Robin Hood steps linearly; robinHood switches on swap-on-insert, early
+// termination and backward-shift deletion
+struct RobinHoodProbePolicy {
+    static const ProbingMethod type = ROBIN_HOOD_PROBING;
+    static const bool robinHood = true;
+    static const char* name(){ return "Robin Hood Probing"; }
+    static int next(int idx, int, int size){
+        return idx+1<size ? idx+1 : 0;
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef HASHQUALITY_H
+#define HASHQUALITY_H
+
+#include <string>
+#include <vector>
+#include "HashRegistry.h"
+#include "SlotReducer.h"
+using namespace std;
+
+// One hash as a table would use it. sized: HashFunctions' size-dependent
+// bitwiseHash/polynomialHash/universalHash, which reduce while hashing.
+// Otherwise the registry's hash64 reduced by SlotReducer (REDUCE_MOD, the
+// table default)
+struct QualityTarget {
+    const HashAlgorithm* algorithm;
+    bool sized;
+};
+
+// Bucket occupancy of the whole corpus against a uniform spread
+struct DistributionResult {
+    double chiSquared;
+    double zScore;         // (chi^2 - (m-1)) / sqrt(2(m-1)); |z| > 3 is suspect
+    int maxBucket;
+    double emptyFraction;
+    double expectedEmpty;  // (1-1/m)^n
+};
+
+// Single-bit input flips over a sample of keys, scored on the slot's bits
+// against what a random function gives for the same table size (for sizes
+// that are not powers of two the high slot bits flip less than half the
+// time even then)
+struct AvalancheResult {
+    long long flips;
+    int outputBits;
+    double changedRatio;  // Slot bits changed / expected; 1.0 is ideal
+    double worstBias;     // Largest |P(flip) - ideal| of one input/output bit pair
+    int worstByte;        // Input byte of that pair
+    double worstBIC;      // Largest |correlation - ideal| between two output bits' flips
+};
+
+// Inserting keys into an empty table of the analyzed size, against the
+// uniform hashing estimates at the same load (Knuth: linear probing, and
+// random probing with secondary clustering for quadratic)
+struct ProbeResult {
+    double load;
+    double expectedHit;
+    double observedHit;
+    double expectedMiss;
+    double observedMiss;
+    int maxProbes;
+    long failed;  // Inserts that found no empty slot (quadratic only)
+};
+
+struct QualityReport {
+    QualityTarget target;
+    int tableSize;
+    long long keys;
+    DistributionResult distribution;
+    AvalancheResult avalanche;
+    ProbeResult linear;
+    ProbeResult quadratic;
+};
+
+// Runs every analysis of one hash at one table size over a fixed corpus.
+// Hashing and the avalanche flips are split across threads, each with its
+// own HashFunctions; probe simulation inserts up to loadFactor*m keys (at
+// most half the corpus) and searches for as many of the remaining keys
+class HashQualityAnalyzer {
+private:
+    const vector<string>& keys;
+    int threads;
+    double loadFactor;
+    int avalancheKeys;
+    
+    void computeSlots(const QualityTarget& target, int tableSize, vector<int>& slots) const;
+    DistributionResult distribution(const vector<int>& slots, int tableSize) const;
+    AvalancheResult avalanche(const QualityTarget& target, int tableSize) const;
+    template <typename ProbePolicy>
+    ProbeResult probes(const vector<int>& slots, int tableSize) const;
+
+public:
+    HashQualityAnalyzer(const vector<string>& corpus, int numThreads);
+    
+    void setLoadFactor(double load);   // Probe simulation load (default 0.5)
+    void setAvalancheKeys(int count);  // Keys whose bits are flipped (default 1000)
+    
+    QualityReport analyze(const QualityTarget& target, int tableSize) const;
+    
+    // Slot of one key, as the table would compute it; reducer gives the size
+    static int slot(HashFunctions& f, const QualityTarget& target, const SlotReducer& reducer,
+                    const char* key, size_t len);
+    
+    // Every registry hash in hash64 form, plus the size-dependent forms of
+    // the three HashFunctions hashes (wide variants give identical values)
+    static vector<QualityTarget> allTargets();
+    static const char* formName(const QualityTarget& target);
+    
+    static bool isPrime(int n);
+    static int previousPrime(int n);  // Largest prime below n
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef HASHREGISTRY_H
+#define HASHREGISTRY_H
+
+#include <cstddef>
+#include "HashFunctions.h"
+#include "HashTypes.h"
+using namespace std;
+
+// One selectable hash function. hash64() returns the same size-independent
+// value as the matching HashPolicy, so menus, the Swiss engine and the
+// benchmarks can go through one table instead of switching on HashType
+struct HashAlgorithm {
+    HashType type;
+    const char* name;        // Menu and stats label
+    const char* shortName;   // One word, for CSV rows and config names
+    unsigned long long (*hash64)(HashFunctions& f, const char* key, size_t len);
+    const char* (*implementation)();  // Code path in use (e.g. "AVX2"), or 0
+};
+
+// Every hash the program offers, in menu order. Adding a hash means a
+// FastHashes/HashFunctions function, a HashType, a policy and one entry here
+class HashRegistry {
+public:
+    static int count();
+    static const HashAlgorithm& get(int index);
+    static const HashAlgorithm& find(HashType type);
+};
+
+#endif
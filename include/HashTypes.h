@@ -1,8 +1,12 @@
 #ifndef HASHTYPES_H
 #define HASHTYPES_H
 
-enum HashType { BITWISE_HASH, POLYNOMIAL_HASH, UNIVERSAL_HASH };
-enum ProbingMethod { LINEAR_PROBING, QUADRATIC_PROBING };
+enum HashType { BITWISE_HASH, POLYNOMIAL_HASH, UNIVERSAL_HASH,
+                BITWISE_WIDE_HASH, POLYNOMIAL_WIDE_HASH, UNIVERSAL_WIDE_HASH,
+                XXHASH64_HASH, WYHASH_HASH, FNV1A_HASH, MURMUR3_HASH, CRC32C_HASH };
+enum ProbingMethod { LINEAR_PROBING, QUADRATIC_PROBING, ROBIN_HOOD_PROBING };
 enum SlotStatus { EMPTY, OCCUPIED, DELETED };
+enum ReductionMethod { REDUCE_MOD, REDUCE_FASTRANGE, REDUCE_POW2 };
+enum TimerSource { TIMER_STEADY, TIMER_TSC };
 
 #endif
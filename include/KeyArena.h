@@ -0,0 +1,44 @@
+#ifndef KEYARENA_H
+#define KEYARENA_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+using namespace std;
+
+//Append-only byte buffer holding a table's keys back to back. Slots refer
+//to their key by offset and length, so inserting a URL never allocates on
+//its own; deleted keys stay in place as dead bytes until the owning table
+//repacks its live keys into a new arena and swaps it in (reclaimKeys in
+//BasicURLHashTable). Offsets are size_t, so the arena may pass 4 GiB
+class KeyArena {
+private:
+    vector<char> bytes;
+    size_t deadBytes;  // Bytes belonging to deleted keys
+
+public:
+    KeyArena();
+    
+    size_t append(const char* key, size_t len);
+    size_t append(const string& key);
+    void release(unsigned int len);
+    string get(size_t offset, unsigned int len) const;
+    
+    void reserve(size_t len);
+    void swap(KeyArena& other);
+    void clear();
+    
+    size_t size() const;
+    size_t capacity() const;
+    size_t getDeadBytes() const;
+    
+    // Probe-loop accessors, kept inline
+    const char* data(size_t offset) const{
+        return bytes.data()+offset;
+    }
+    bool equals(size_t offset, const string& key) const{
+        return key.empty() || memcmp(bytes.data()+offset, key.data(), key.size())==0;
+    }
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef LOGHISTOGRAM_H
+#define LOGHISTOGRAM_H
+
+#include <vector>
+using namespace std;
+
+//Log-linear (HDR-style) histogram of non-negative integers such as probe
+//counts or latencies in nanoseconds. Values below 2*SUB_BUCKETS get a
+//bucket each; above that every power of two is split into SUB_BUCKETS
+//equal buckets, so a reported percentile is within 1/SUB_BUCKETS (about
+//3%) of the true value. Buckets are allocated up to the largest value seen
+class LogHistogram {
+public:
+    static const int SUB_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+
+private:
+    vector<unsigned long long> counts;
+    unsigned long long total;
+    unsigned long long maxValue;
+    
+    static int bucketOf(unsigned long long value);
+    static unsigned long long bucketHigh(int bucket);
+
+public:
+    LogHistogram();
+    
+    void record(unsigned long long value);
+    void merge(const LogHistogram& other);
+    void reset();
+    
+    unsigned long long getCount() const;
+    unsigned long long getMax() const;
+    
+    // Smallest bucket bound with at least p percent of the values at or
+    // below it (capped at the largest value recorded); 0 when empty
+    unsigned long long percentile(double p) const;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef MAPPEDURLFILE_H
+#define MAPPEDURLFILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+// URL bytes inside a MappedURLFile (pointer and length, not a copy)
+struct URLView {
+    const char* data;
+    size_t len;
+    
+    string str() const{ return string(data, len); }
+};
+
+// URL input file mapped read-only into memory and parsed in place. The
+// format is the one the loaders always used: the first line holds the
+// suggested table size, the rest are comma-separated URLs. Each URL is
+// trimmed of spaces, tabs and line ends and kept only if it has a known
+// scheme (URLKeyCodec). The URLs come back in file order as views into the
+// mapping, valid until close() or destruction.
+// Large files can be parsed by several threads, each taking a run of whole
+// lines. Where memory mapping is not available the file is read into one
+// buffer instead
+class MappedURLFile {
+private:
+    const char* base;
+    size_t length;
+    bool mapped;  // false: base is a heap buffer owned by this object
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+    int tableSize;
+    vector<URLView> urls;
+    
+    MappedURLFile(const MappedURLFile&);
+    MappedURLFile& operator=(const MappedURLFile&);
+
+public:
+    // Smallest share of the file worth a parse thread of its own
+    static const size_t MIN_CHUNK_BYTES = 1 << 20;
+    
+    MappedURLFile();
+    ~MappedURLFile();
+    
+    // false if the file cannot be opened or mapped. threads caps the
+    // number of parse threads (1: parse on the calling thread)
+    bool open(const string& filename, int threads);
+    void close();
+    
+    int getTableSize() const;  // 0 if the first line holds no number
+    const vector<URLView>& getURLs() const;
+    size_t getFileBytes() const;
+    bool isMapped() const;
+    
+    // The parsing rules, for readers that get the file in pieces (see
+    // URLStreamPipeline). parseTableSize reads the first line the way
+    // `stream >> int` does; parseLines appends the accepted URLs of the
+    // whole lines in [begin, end)
+    static int parseTableSize(const char* begin, const char* end);
+    static void parseLines(const char* begin, const char* end, vector<URLView>& out);
+};
+
+#endif
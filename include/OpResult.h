@@ -0,0 +1,15 @@
+#ifndef OPRESULT_H
+#define OPRESULT_H
+
+// Outcome of one table operation, returned without any console output
+class OpResult {
+public:
+    bool success;    // Found / inserted / deleted
+    int slot;        // Slot holding the URL (existing slot on a duplicate insert), -1 if none
+    int probes;      // URL string comparisons made
+    double elapsed;  // Seconds spent in the operation (0 if it was not timed)
+    
+    OpResult();
+};
+
+#endif
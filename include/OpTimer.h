@@ -0,0 +1,80 @@
+#ifndef OPTIMER_H
+#define OPTIMER_H
+
+#include <chrono>
+#include "HashTypes.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define OP_TIMER_TSC 1
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define OP_TIMER_TSC 1
+#endif
+
+using namespace std;
+
+//Times table operations for Statistics.
+//  TIMER_STEADY: std::chrono::steady_clock (wall clock, nanosecond ticks on
+//                the usual platforms)
+//  TIMER_TSC:    the CPU timestamp counter, calibrated against steady_clock
+//                once per process; needs an x86 CPU with an invariant TSC
+//Every interval has the median cost of two back-to-back reads subtracted.
+//The sample interval picks which single operations are timed: 1 times all
+//of them, N every Nth, and 0 none, leaving only batch calls, which are
+//timed as a whole
+class OpTimer {
+private:
+    TimerSource source;
+    int sampleEvery;
+    int countdown;  // Operations until the next timed one
+    double secondsPerTick;
+    double overheadTicks;
+
+public:
+    OpTimer();
+    
+    // false if the TSC is not usable here; steady_clock is kept then
+    bool setSource(TimerSource timer);
+    void setSampleInterval(int every);
+    
+    TimerSource getSource() const{ return source; }
+    int getSampleInterval() const{ return sampleEvery; }
+    double getOverhead() const{ return overheadTicks*secondsPerTick; }
+    
+    // Hot-path helpers, kept inline
+    bool sample(){
+        if(sampleEvery<=0 || --countdown>0){
+            return false;
+        }
+        countdown = sampleEvery;
+        return true;
+    }
+    
+    unsigned long long now() const{
+#ifdef OP_TIMER_TSC
+        if(source==TIMER_TSC){
+            return readTSC();
+        }
+#endif
+        return chrono::steady_clock::now().time_since_epoch().count();
+    }
+    
+    double seconds(unsigned long long start, unsigned long long end) const{
+        double ticks = (double)(end-start) - overheadTicks;
+        return ticks>0 ? ticks*secondsPerTick : 0.0;
+    }
+    
+#ifdef OP_TIMER_TSC
+    // The fence keeps earlier instructions from drifting past the read
+    static unsigned long long readTSC(){
+        _mm_lfence();
+        return __rdtsc();
+    }
+#endif
+    
+    static bool tscSupported();
+    static const char* sourceName(TimerSource timer);
+};
+
+#endif
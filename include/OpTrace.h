@@ -0,0 +1,90 @@
+#ifndef OPTRACE_H
+#define OPTRACE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "URLHashTable.h"
+
+using namespace std;
+
+enum TraceCommand { TRACE_SEARCH, TRACE_INSERT, TRACE_DELETE, TRACE_COMPACT, NUM_TRACE_COMMANDS };
+
+struct TraceRecord {
+    TraceCommand command;
+    string url;  // Empty for TRACE_COMPACT
+};
+
+// Operation trace files, in two formats:
+//   text   - one command per line, as typed in interactive mode:
+//            hashSearch,<URL> / hashInsert,<URL> / hashDelete,<URL> /
+//            hashCompact. Other lines are skipped
+//   binary - "URLTRACE" and a version byte, then per record a command
+//            byte, the URL length (4 bytes, little-endian) and the URL
+// Binary traces skip line parsing and allow any byte in a URL
+class TraceWriter {
+private:
+    ofstream file;
+    bool binary;
+    long count;
+
+public:
+    TraceWriter();
+    
+    bool open(const string& filename, bool binaryFormat);
+    void write(TraceCommand command, const string& url);
+    void close();
+    
+    bool isOpen() const;
+    long getCount() const;
+    
+    // Format picked from the name: binary for ".bin", text otherwise
+    static bool isBinaryName(const string& filename);
+};
+
+class TraceReader {
+private:
+    ifstream file;
+    bool binary;
+    long skipped;
+    string line;
+
+public:
+    TraceReader();
+    
+    // Detects the format from the file's first bytes
+    bool open(const string& filename);
+    
+    // false at the end of the trace (or at a truncated binary record)
+    bool next(TraceRecord& record);
+    
+    bool isBinary() const;
+    long getSkipped() const;  // Unrecognized text lines
+    
+    static const char* commandName(TraceCommand command);  // As in text traces
+};
+
+struct ReplaySummary {
+    long ops[NUM_TRACE_COMMANDS];
+    long succeeded[NUM_TRACE_COMMANDS];
+    long totalOps;
+    double seconds;  // Table operations only, trace reading excluded
+};
+
+// Replays a trace against a table at full speed: records are read a chunk
+// at a time and only the table calls are timed. Operations go through the
+// silent OpResult calls, so no observer output slows them down; latency and
+// probe percentiles come from the table's own Statistics
+class TraceReplayer {
+private:
+    URLHashTable& table;
+    int chunkSize;
+
+public:
+    TraceReplayer(URLHashTable& target);
+    
+    void setChunkSize(int records);  // Records read ahead per timed chunk (default 65536)
+    ReplaySummary replay(TraceReader& reader);
+};
+
+#endif
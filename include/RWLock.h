@@ -0,0 +1,40 @@
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include <atomic>
+using namespace std;
+
+// Reader-writer spin lock for short critical sections (C++11 has no
+// shared_mutex). Any number of readers hold it together; a writer holds it
+// alone. A waiting writer keeps new readers out, so a steady stream of
+// searches cannot starve inserts. lock()/unlock() fit lock_guard
+class RWLock {
+private:
+    static const int WRITER = 1 << 30;
+    
+    atomic<int> state;           // Readers inside, plus WRITER while one holds it
+    atomic<int> writersWaiting;
+
+public:
+    RWLock();
+    
+    void lockShared();
+    void unlockShared();
+    void lock();
+    void unlock();
+};
+
+// Scoped shared hold, the reader counterpart of lock_guard
+class ReadGuard {
+private:
+    RWLock& held;
+    
+    ReadGuard(const ReadGuard&);
+    ReadGuard& operator=(const ReadGuard&);
+
+public:
+    explicit ReadGuard(RWLock& lock) : held(lock){ held.lockShared(); }
+    ~ReadGuard(){ held.unlockShared(); }
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef SHARDEDURLHASHTABLE_H
+#define SHARDEDURLHASHTABLE_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include "URLHashTable.h"
+#include "RWLock.h"
+#include "Statistics.h"
+#include "OpTimer.h"
+#include "HashTypes.h"
+#include "OpResult.h"
+#include "TableObserver.h"
+
+using namespace std;
+
+// Thread-safe table made of independent URLHashTable shards. A URL always
+// goes to the shard picked by the high bits of a fixed routing hash
+// (wyhash, separate from the table hash, so switching the hash function
+// never moves a URL between shards). Each shard has a reader-writer lock:
+// searches share it, inserts, deletes and settings take it alone.
+// A search records into its thread's own statistics and timer for that
+// shard (indexed by EpochReclaimer::threadIndex), so readers write nothing
+// in common; these are merged with the shard's insert/delete statistics
+// when asked for
+class ShardedURLHashTable {
+private:
+    // One thread's searches on one shard
+    struct ReaderStats {
+        Statistics stats;
+        OpTimer timer;
+        string scratch;  // Encoded key of the current search
+        char pad[64];
+    };
+    
+    struct Shard {
+        URLHashTable* table;
+        RWLock lock;
+        atomic<ReaderStats*>* readers;  // Per thread index, created on first search
+        TimerSource timerSource;        // Given to new readers' timers
+        int sampleEvery;
+        TableObserver* observer;        // For searchURL, which bypasses the table's
+        char pad[64];  // Keeps neighbouring shards' locks off one cache line
+    };
+    
+    Shard* shards;
+    int numShards;
+    HashType current_hType;
+    ProbingMethod current_pType;
+    
+    Shard& shardFor(const string& url);
+    ReaderStats& readerFor(Shard& shard);
+    Statistics shardStats(Shard& shard);
+
+public:
+    // tableSize is split evenly over the shards
+    ShardedURLHashTable(int tableSize, int shardCount);
+    ~ShardedURLHashTable();
+    
+    // Settings apply to every shard. The observer is called from whichever
+    // thread ran the operation, with that shard's lock held; searches hold
+    // it shared, so several may report at once
+    void setHashFunction(HashType hashType);
+    void setProbingMethod(ProbingMethod probingType);
+    void setMaxLoadFactor(double loadFactor);
+    void setMigrationBatch(int buckets);
+    void setTombstoneThreshold(double ratio);
+    void setKeyEncoding(bool enabled);
+    void setReduction(ReductionMethod method);
+    bool setTimerSource(TimerSource source);
+    void setSampleInterval(int every);  // Counted per shard and search thread
+    void setObserver(TableObserver* tableObserver);
+    
+    // Silent operations with structured results; slot is within the shard
+    OpResult search(const string& url);
+    OpResult insert(const string& url);
+    OpResult remove(const string& url);
+    
+    // Same operations, reported to the attached observer
+    bool searchURL(const string& url);
+    bool insertURL(const string& url);
+    bool deleteURL(const string& url);
+    void compactTombstones();
+    
+    void displayStats();
+    void resetStats();
+    
+    double getLoadFactor();
+    int getSize();
+    int getNumElements();
+    int getNumShards() const;
+    int shardOf(const string& url) const;
+    
+    // Merged over all shards, or for one shard
+    Statistics getStats();
+    Statistics getShardStats(int shard);
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef SLOTREDUCER_H
+#define SLOTREDUCER_H
+
+#include "HashTypes.h"
+using namespace std;
+
+//Maps a 64-bit hash to a slot in [0, size) without a hardware divide.
+//  REDUCE_MOD:       hash % size, as a mask for power-of-two sizes and as a
+//                    multiply by a precomputed reciprocal otherwise
+//  REDUCE_FASTRANGE: (hash * size) >> 64, which uses the hash's high bits
+//  REDUCE_POW2:      hash & (size-1); the table rounds its size up to a
+//                    power of two first
+class SlotReducer {
+private:
+    int size;
+    ReductionMethod method;
+    bool powerOfTwo;
+    unsigned long long mask;        // size-1 when size is a power of two
+    unsigned long long reciprocal;  // floor((2^64-1) / size)
+
+public:
+    SlotReducer();
+    SlotReducer(int tableSize, ReductionMethod reduction);
+    
+    int getSize() const{ return size; }
+    ReductionMethod getMethod() const{ return method; }
+    
+    // Probe-loop helpers, kept inline
+    int reduce(unsigned long long hash) const{
+        if(method==REDUCE_FASTRANGE){
+            return (int)mulHigh(hash, (unsigned long long)size);
+        }
+        if(powerOfTwo){
+            return (int)(hash & mask);
+        }
+        //The estimate is the true quotient or one below it
+        unsigned long long r = hash - mulHigh(hash, reciprocal)*size;
+        return (int)(r>=(unsigned long long)size ? r-size : r);
+    }
+    
+    static unsigned long long mulHigh(unsigned long long a, unsigned long long b){
+#if defined(__SIZEOF_INT128__)
+        return (unsigned long long)(((unsigned __int128)a * b) >> 64);
+#else
+        unsigned long long aLo = (unsigned int)a, aHi = a >> 32;
+        unsigned long long bLo = (unsigned int)b, bHi = b >> 32;
+        unsigned long long cross = (aLo*bLo >> 32) + (unsigned int)(aHi*bLo) + aLo*bHi;
+        return aHi*bHi + (aHi*bLo >> 32) + (cross >> 32);
+#endif
+    }
+    
+    static bool isPowerOfTwo(int n);
+    static int nextPowerOfTwo(int n);
+    static const char* methodName(ReductionMethod reduction);
+};
+
+#endif
@@ -3,29 +3,82 @@
 
 #include <iostream>
 #include <iomanip>
-#include <ctime>
 #include "HashTypes.h"
+#include "LogHistogram.h"
 
 using namespace std;
 
+// Operation types with separate probe and latency histograms
+enum OpKind { OP_SEARCH_HIT, OP_SEARCH_MISS, OP_INSERT, OP_DELETE, NUM_OP_KINDS };
+
 class Statistics {
 private:
-    int numComp;
+    // 64-bit so corpora of a billion keys and more do not overflow
+    long long numComp;
     int maxComp;
-    int numQueries;
-    clock_t totalTime;
+    long long numQueries;
+    
+    // Operation timing in seconds; with sampling only numTimed of the
+    // numQueries operations are timed
+    double totalTime;
+    long long numTimed;
+    
+    // Incremental growth cost
+    int numGrowths;
+    int numMigrationSteps;
+    int numMigrated;
+    int maxMigrated;
+    double migrationTime;
+    
+    // In-place tombstone cleanup
+    int numCompactions;
+    int numTombstonesRemoved;
+    long numBytesReclaimed;
+    double compactionTime;
     
+    // Slot comparisons settled by the inline hash/length/tag check
+    long long numAvoided;
+    
+    // Per operation type: probes of every operation, and latency in ns of
+    // every individually timed one (batch intervals only feed the average)
+    LogHistogram probeHist[NUM_OP_KINDS];
+    LogHistogram latencyHist[NUM_OP_KINDS];
+
 public:
     Statistics();
-    void recordQuery(int comp, clock_t time);
+    void recordQuery(OpKind kind, int comp);
+    void recordTime(OpKind kind, double seconds);   // One operation
+    void recordBatchTime(double seconds, int ops);  // One interval covering ops operations
+    void recordGrowth();
+    void recordMigration(int moved, double seconds);
+    void recordCompaction(int tombstonesRemoved, long bytesReclaimed, double seconds);
+    void recordAvoidedCompares(int avoided);
+    void merge(const Statistics& other);  // Adds other's counts (maxima take the larger)
     void reset();
     void display(int tableSize, int numElements, double loadFactor, HashType hashType);
+    void displayMigration(int bucketsDone, int bucketsTotal);
+    void displayTombstones(int tombstones, int tableSize, double threshold);
+    void displayCompares();
+    void displayPercentiles();
+    void displayKeyStorage(int numKeys, long slotBytes, long arenaBytes, long deadBytes, long stringLayoutBytes);
     
-    int getTotalComp() const;
+    long long getTotalComp() const;
     int getMaxComp() const;
-    int getNumQueries() const;
+    long long getNumQueries() const;
     double getAvgComparisons() const;
-    double getAvgTime() const;
+    double getAvgTime() const;  // Over the timed operations
+    long long getNumTimed() const;
+    const LogHistogram& getProbeHistogram(OpKind kind) const;
+    const LogHistogram& getLatencyHistogram(OpKind kind) const;  // Nanoseconds
+    
+    int getNumGrowths() const;
+    int getNumMigrated() const;
+    int getMaxMigrated() const;
+    double getAvgMigrationTime() const;
+    int getNumCompactions() const;
+    long long getAvoidedCompares() const;
+    
+    static const char* opKindName(OpKind kind);
 };
 
 #endif
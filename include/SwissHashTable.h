@@ -0,0 +1,74 @@
+#ifndef SWISSHASHTABLE_H
+#define SWISSHASHTABLE_H
+
+#include <vector>
+#include <string>
+#include "HashFunctions.h"
+#include "HashRegistry.h"
+#include "SlotReducer.h"
+#include "Statistics.h"
+#include "OpTimer.h"
+#include "HashTypes.h"
+#include "OpResult.h"
+#include "TableObserver.h"
+
+using namespace std;
+
+//Swiss-table style engine: one control byte per slot (empty, deleted, or a
+//7-bit hash fingerprint) kept apart from the URL slots, probed 16 at a time
+class SwissHashTable {
+private:
+    static const int GROUP_WIDTH = 16;
+    static const signed char CTRL_EMPTY = -128;  // 0x80
+    static const signed char CTRL_DELETED = -2;  // 0xFE
+    
+    vector<signed char> ctrl;
+    vector<string> slots;
+    int numGroups;
+    SlotReducer groupReducer;  // Hash bits above H2 to a home group
+    int size;
+    int numElements;
+    HashFunctions hashFunc;
+    Statistics stats;
+    OpTimer timer;
+    HashType current_hType;
+    const HashAlgorithm* hashAlgo;  // Registry entry for current_hType
+    TableObserver* observer;
+    
+    unsigned long long hashURL(const string& url);
+    unsigned int matchFingerprint(int group, signed char h2) const;
+    unsigned int matchEmpty(int group) const;
+    unsigned int matchEmptyOrDeleted(int group) const;
+    int findSlot(const string& url, unsigned long long hash, int& comp);
+
+public:
+    SwissHashTable(int tableSize);
+    ~SwissHashTable();
+    
+    void setHashFunction(HashType hashType);
+    bool setTimerSource(TimerSource source);
+    void setSampleInterval(int every);  // 0: operations are not timed
+    void setObserver(TableObserver* tableObserver);
+    
+    // Silent operations with structured results
+    OpResult search(const string& url);
+    OpResult insert(const string& url);
+    OpResult remove(const string& url);
+    
+    // Same operations, reported to the attached observer
+    bool searchURL(const string& url);
+    bool insertURL(const string& url);
+    bool deleteURL(const string& url);
+    
+    void displayStats();
+    void resetStats();
+    
+    double getLoadFactor();
+    int getSize();
+    int getNumElements();
+    
+    // Get statistics
+    const Statistics& getStats() const;
+};
+
+#endif
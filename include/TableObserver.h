@@ -0,0 +1,29 @@
+#ifndef TABLEOBSERVER_H
+#define TABLEOBSERVER_H
+
+#include <string>
+#include "OpResult.h"
+using namespace std;
+
+// Optional sink for per-operation events. Tables only call it when one is
+// attached, so benchmarks that never attach one do no I/O per operation
+class TableObserver {
+public:
+    virtual ~TableObserver();
+    
+    virtual void onSearch(const string& url, const OpResult& result);
+    virtual void onInsert(const string& url, const OpResult& result);
+    virtual void onDelete(const string& url, const OpResult& result);
+    virtual void onTableFull(const string& url);
+};
+
+// Prints the interactive HIT / NOT found / deleted messages to cout
+class ConsoleObserver : public TableObserver {
+public:
+    void onSearch(const string& url, const OpResult& result);
+    void onInsert(const string& url, const OpResult& result);
+    void onDelete(const string& url, const OpResult& result);
+    void onTableFull(const string& url);
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef TABLEPROFILE_H
+#define TABLEPROFILE_H
+
+#include <iostream>
+#include <vector>
+#include "HashTypes.h"
+using namespace std;
+
+// One maximal run of non-EMPTY slots (occupied or tombstone). A lookup that
+// starts inside a run steps through it, so long runs are primary clustering
+struct ClusterRun {
+    int start;       // First slot; the last run may wrap past the table's end
+    int length;
+    int tombstones;
+};
+
+// Table layout gathered in one pass over the slots (engines fill it in
+// profileTable): cluster run lengths, each entry's displacement from its
+// home slot, where the tombstones are and the longest runs. Meant for live
+// tables of any size, where displayTable's slot-by-slot listing is not
+class TableProfile {
+public:
+    static const int NUM_SEGMENTS = 64;  // Equal table regions for the occupancy map
+    
+    int tableSize;
+    int occupied;
+    int tombstones;
+    int pendingMigration;  // Entries still in the previous table during growth
+    long numRuns;
+    long runsWithTombstones;
+    
+    vector<long> runLengths;    // [n]: runs of n slots
+    vector<long> displacement;  // [d]: entries d probe steps from home (slots, for linear probing)
+    vector<int> segmentOccupied;
+    vector<int> segmentTombstones;
+    vector<ClusterRun> largest;  // Longest runs, longest first
+    
+    TableProfile();
+    
+    // The one pass: begin, a slot() call per slot in index order, finish
+    void begin(int size, int topClusters);
+    void slot(int idx, SlotStatus status, int dist);
+    void finish();
+    
+    double meanRunLength() const;
+    int longestRun() const;
+    double meanDisplacement() const;
+    int maxDisplacement() const;
+    
+    // Slots a miss examines when scanning linearly from a uniformly random
+    // slot, from the actual runs, and the uniform hashing estimate at the
+    // same fill (1 + 1/(1-a)^2)/2: a ratio well above 1 is primary clustering
+    double linearMissCost() const;
+    double uniformMissCost() const;
+    
+    void display() const;
+    
+    // Rows of Metric,Key,Count,Tombstones: RunLength (key: length),
+    // Displacement (key: steps), Segment (key: first slot, count: occupied)
+    // and LargestCluster (key: first slot, count: length). Tombstones is
+    // left empty on RunLength and Displacement rows
+    void writeCSV(ostream& out) const;
+
+private:
+    int topK;
+    ClusterRun current;
+    ClusterRun first;  // Run starting at slot 0, merged with the last if that one wraps
+    bool inRun;
+    
+    void closeRun(const ClusterRun& run);
+};
+
+#endif
@@ -3,47 +3,98 @@
 
 #include <vector>
 #include <string>
-#include <ctime>
-#include "HashEntry.h"
-#include "HashFunctions.h"
 #include "Statistics.h"
+#include "OpTimer.h"
 #include "HashTypes.h"
+#include "OpResult.h"
+#include "TableObserver.h"
+#include "TableProfile.h"
+#include "URLTableEngine.h"
 
 using namespace std;
 
+// Runtime-selectable facade over BasicURLHashTable<HashPolicy, ProbePolicy>.
+// Changing the hash function or probing method swaps in the matching
+// specialized engine (re-inserting any URLs already stored)
 class URLHashTable {
 private:
-    vector<HashEntry> table;
-    int size;
-    int numElements;
-    HashFunctions hashFunc;
-    Statistics stats;
+    URLTableEngine* engine;
     HashType current_hType;
     ProbingMethod current_pType;
     
-    int probe(unsigned long hash, int i);
+    // Settings re-applied whenever the engine is rebuilt
+    double maxLoadFactor;
+    int migrateBatch;
+    double tombstoneThreshold;
+    bool keyEncoding;
+    ReductionMethod reduction;
+    bool prefetch;
+    TimerSource timerSource;
+    int sampleInterval;
+    TableObserver* observer;
     
+    void rebuildEngine();
+
 public:
     URLHashTable(int tableSize);
     ~URLHashTable();
     
     void setHashFunction(HashType hashType);
     void setProbingMethod(ProbingMethod probingType);
+    void setMaxLoadFactor(double loadFactor);
+    void setMigrationBatch(int buckets);
+    void setTombstoneThreshold(double ratio);
+    void setKeyEncoding(bool enabled);
+    void setReduction(ReductionMethod method);
+    void setPrefetch(bool enabled);
+    bool setTimerSource(TimerSource source);  // false: no usable TSC, steady_clock kept
+    void setSampleInterval(int every);        // Time every-th operation; 0 times batches only
+    void setObserver(TableObserver* tableObserver);
+    
+    // Silent operations with structured results
+    OpResult search(const string& url);
+    OpResult insert(const string& url);
+    OpResult remove(const string& url);
+    
+    // search recording into the caller's statistics, timer and key scratch
+    // instead of the table's, so concurrent readers need only a shared lock
+    OpResult searchShared(const string& url, Statistics& readerStats, OpTimer& readerTimer, string& scratch);
     
+    // Batched search/insert with software prefetching; results must hold
+    // count entries. Worth it once the table no longer fits in cache
+    void searchBatch(const string* urls, int count, OpResult* results);
+    void insertBatch(const string* urls, int count, OpResult* results);
+    
+    // insertBatch with hashes[i] = HashRegistry::find(getHashFunction())
+    // .hash64 of urls[i], computed ahead by the caller. With key encoding on
+    // the table hashes the encoded key instead, so hashes goes unused
+    void insertBatch(const string* urls, const unsigned long long* hashes, int count, OpResult* results);
+    
+    // Same operations, reported to the attached observer
     bool searchURL(const string& url);
     bool insertURL(const string& url);
     bool deleteURL(const string& url);
+    void compactTombstones();
     
     void displayTable();
+    void profileTable(TableProfile& profile, int topClusters);
     void displayStats();
     void resetStats();
     
     double getLoadFactor();
     int getSize();
     int getNumElements();
+    int getNumTombstones();
+    double getTombstoneRatio();
+    bool isMigrating();
+    HashType getHashFunction() const;
+    bool getKeyEncoding() const;
     
     // Get statistics
     const Statistics& getStats() const;
+    
+    // Specialized engine for a configuration (caller owns it)
+    static URLTableEngine* createEngine(HashType hashType, ProbingMethod probingType, int tableSize);
 };
 
 #endif
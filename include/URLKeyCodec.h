@@ -0,0 +1,60 @@
+#ifndef URLKEYCODEC_H
+#define URLKEYCODEC_H
+
+#include <string>
+#include <vector>
+using namespace std;
+
+//Compact key form for URLs. The scheme (with an optional "www.") becomes a
+//one-byte code and the host a small interned id, so hashing and comparing
+//only walk the bytes that tell two URLs apart. An encoded key is
+//  [scheme code][host id as a 1-5 byte varint][rest of the URL]
+//URLs without a known scheme are kept as [0][URL]
+class URLKeyCodec {
+private:
+    // Host strings by id; a released id keeps an empty string until reused
+    vector<string> hosts;
+    vector<unsigned int> freeIds;
+    
+    // Open-addressed index over hosts: id+1 per slot, 0 for empty. A power
+    // of two in size and at most half full. Lookups hash the host bytes in
+    // place inside the URL, so finding a host copies nothing
+    vector<unsigned int> index;
+    
+    static unsigned long long hostHash(const char* host, size_t len);
+    int findSlot(const char* host, size_t len) const;
+    void growIndex();
+    static bool readId(const char* key, size_t len, size_t& pos, unsigned int& id);
+
+public:
+    URLKeyCodec();
+    
+    // Scheme code of url (0 if none) and the length of the prefix it covers
+    static int schemeCode(const string& url, size_t& prefixLen);
+    static int schemeCode(const char* url, size_t len, size_t& prefixLen);
+    static bool hasKnownScheme(const string& url);
+    static bool hasKnownScheme(const char* url, size_t len);
+    
+    // Writes the encoded form of url to out. New hosts are added only when
+    // intern is set; otherwise an unseen host returns false, since no stored
+    // key can contain it. Without interning encode only reads the codec, so
+    // concurrent readers may share it. added reports a newly interned host,
+    // which the caller releases if the key is not stored after all
+    bool encode(const string& url, string& out, bool intern);
+    bool encode(const string& url, string& out, bool intern, bool& added);
+    string decode(const char* key, size_t len) const;
+    
+    // Host id inside an encoded key; false for a key with no host
+    static bool hostId(const char* key, size_t len, unsigned int& id);
+    
+    // Drops a host no stored key refers to; its id is handed out again
+    void release(unsigned int id);
+    
+    int getNumHosts() const;
+    
+    // Heap footprint of the dictionary: host strings (object and any buffer
+    // past the inline capacity), the index and the free id list
+    size_t getMemoryBytes() const;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef URLSTREAMPIPELINE_H
+#define URLSTREAMPIPELINE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "URLHashTable.h"
+#include "BoundedQueue.h"
+
+using namespace std;
+
+// One pipeline stage's totals. busySeconds leaves out time spent waiting on
+// the queues around the stage
+struct PipelineStage {
+    const char* name;
+    long items;                // URLs out of the stage (blocks for the reader)
+    unsigned long long bytes;
+    double busySeconds;
+};
+
+struct PipelineQueue {
+    const char* name;
+    size_t capacity;
+    double avgOccupancy;
+    size_t maxOccupancy;
+    long fullWaits;   // Producer stalled: the next stage is the bottleneck
+    long emptyWaits;  // Consumer stalled: the previous stage is
+};
+
+// Streams a URL file into a URLHashTable without holding the corpus in
+// memory. Four stages on their own threads overlap I/O, parsing, hashing
+// and inserting:
+//   read   - fixed-size blocks, cut at the last newline
+//   parse  - table size line, then URLs by the MappedURLFile rules, batched
+//   hash   - HashRegistry hash64 of every URL, for the table's hash function
+//            (batches pass through unhashed when the table encodes keys,
+//            since it hashes the encoded form itself)
+//   insert - insertBatch with the precomputed hashes (the calling thread)
+// Bounded queues link the stages, so at most queueDepth blocks and
+// 2*queueDepth batches are in flight besides one per stage. The table still
+// grows with the distinct URLs it stores.
+// The table must not be used or reconfigured elsewhere during run()
+class URLStreamPipeline {
+public:
+    enum StageId { STAGE_READ, STAGE_PARSE, STAGE_HASH, STAGE_INSERT, NUM_STAGES };
+
+private:
+    struct URLBatch {
+        vector<string> urls;
+        vector<unsigned long long> hashes;
+    };
+    
+    URLHashTable& table;
+    size_t blockBytes;
+    int batchSize;
+    size_t queueDepth;
+    
+    int tableSize;
+    long inserted;
+    double wallSeconds;
+    PipelineStage stages[NUM_STAGES];
+    PipelineQueue queues[NUM_STAGES-1];
+    
+    void readStage(ifstream& file, BoundedQueue<string>& out);
+    void parseStage(BoundedQueue<string>& in, BoundedQueue<URLBatch>& out);
+    void hashStage(BoundedQueue<URLBatch>& in, BoundedQueue<URLBatch>& out);
+    void insertStage(BoundedQueue<URLBatch>& in);
+    
+    template <typename T>
+    static PipelineQueue queueStats(const char* name, const BoundedQueue<T>& queue);
+
+public:
+    URLStreamPipeline(URLHashTable& target);
+    
+    void setBlockBytes(size_t bytes);  // Read size (default 64 KB)
+    void setBatchSize(int urls);       // URLs per batch (default 256)
+    void setQueueDepth(size_t items);  // Capacity of each queue (default 8)
+    
+    // false if the file cannot be opened
+    bool run(const string& filename);
+    
+    int getTableSize() const;  // First line of the file; 0 if none
+    long getInserted() const;  // URLs the table accepted
+    double getWallSeconds() const;
+    const PipelineStage& getStage(int stage) const;
+    const PipelineQueue& getQueue(int queue) const;  // Queue i feeds stage i+1
+    
+    void displayStats() const;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef URLTABLEENGINE_H
+#define URLTABLEENGINE_H
+
+#include <vector>
+#include <string>
+#include "Statistics.h"
+#include "OpTimer.h"
+#include "OpResult.h"
+#include "TableObserver.h"
+#include "TableProfile.h"
+#include "HashTypes.h"
+
+using namespace std;
+
+// Runtime interface over the BasicURLHashTable instantiations, used by the
+// URLHashTable facade to pick a configuration from the menu. Dispatch costs
+// one virtual call per operation; the probe loop itself is fully specialized
+class URLTableEngine {
+public:
+    virtual ~URLTableEngine();
+    
+    virtual void setMaxLoadFactor(double loadFactor) = 0;
+    virtual void setMigrationBatch(int buckets) = 0;
+    virtual void setTombstoneThreshold(double ratio) = 0;
+    virtual void setKeyEncoding(bool enabled) = 0;
+    virtual void setReduction(ReductionMethod method) = 0;
+    virtual void setPrefetch(bool enabled) = 0;
+    virtual bool setTimerSource(TimerSource source) = 0;
+    virtual void setSampleInterval(int every) = 0;
+    virtual void setObserver(TableObserver* tableObserver) = 0;
+    
+    virtual OpResult search(const string& url) = 0;
+    virtual OpResult insert(const string& url) = 0;
+    virtual OpResult remove(const string& url) = 0;
+    virtual OpResult searchShared(const string& url, Statistics& readerStats, OpTimer& readerTimer, string& scratch) = 0;
+    virtual void searchBatch(const string* urls, int count, OpResult* results) = 0;
+    virtual void insertBatch(const string* urls, int count, OpResult* results) = 0;
+    virtual void insertBatch(const string* urls, const unsigned long long* hashes, int count, OpResult* results) = 0;
+    
+    virtual bool searchURL(const string& url) = 0;
+    virtual bool insertURL(const string& url) = 0;
+    virtual bool deleteURL(const string& url) = 0;
+    virtual void compactTombstones() = 0;
+    
+    virtual void displayTable() = 0;
+    virtual void profileTable(TableProfile& profile, int topClusters) = 0;
+    virtual void displayStats() = 0;
+    virtual void resetStats() = 0;
+    
+    virtual double getLoadFactor() = 0;
+    virtual int getSize() = 0;
+    virtual int getNumElements() = 0;
+    virtual int getNumTombstones() = 0;
+    virtual double getTombstoneRatio() = 0;
+    virtual bool isMigrating() = 0;
+    
+    // Used when the facade switches configuration on a non-empty table
+    virtual void collectURLs(vector<string>& urls) = 0;
+    virtual void setStats(const Statistics& statistics) = 0;
+    
+    virtual const Statistics& getStats() const = 0;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef URLWORKLOAD_H
+#define URLWORKLOAD_H
+
+#include <string>
+#include "Statistics.h"
+using namespace std;
+
+// Zipfian ranks over [0, items) by Gray et al.'s method (as in YCSB): rank 0
+// is the most popular. theta in (0, 1); YCSB uses 0.99. Setup sums the
+// zeta series exactly up to 10^7 items and estimates the rest, so it stays
+// fast for 10^9 items
+class ZipfianGenerator {
+private:
+    long long items;
+    double theta;
+    double zetan;
+    double alpha;
+    double eta;
+    double half;  // 1 + 0.5^theta
+
+public:
+    ZipfianGenerator(long long numItems, double skew);
+    
+    long long sample(double u) const;  // u uniform in [0, 1)
+    long long getItems() const;
+    
+    static double zeta(long long n, double skew);
+};
+
+// Deterministic synthetic URL corpus. Key i always yields the same URL for
+// a given seed, so a corpus of any size (10^4 to 10^9 keys) is generated on
+// the fly and never stored, and can be split across threads by key range.
+// Distinct keys give distinct URLs.
+// Hosts (about one per 50 keys) are drawn with Zipfian popularity, each
+// with a fixed scheme, optional subdomain and weighted TLD. Paths have
+// 0-5 segments of dictionary words and random slugs, the last one ending in
+// the key id, plus optional extensions and query strings (some long,
+// tracking-style) for a realistic length tail.
+// absent=true gives the URL of a key that is never in the corpus: same host
+// and path shape, different last segment
+class URLCorpus {
+private:
+    unsigned long long seed;
+    long long numHosts;
+    ZipfianGenerator hostPopularity;
+    
+    void appendHost(long long host, string& out) const;
+
+public:
+    // expectedKeys sizes the host pool; url() accepts any key >= 0
+    URLCorpus(long long expectedKeys, unsigned long long corpusSeed);
+    
+    void url(long long key, bool absent, string& out) const;
+    string url(long long key) const;
+    
+    long long getNumHosts() const;
+    unsigned long long getSeed() const;
+};
+
+// Operation ratios; normalized, so any non-negative weights work
+struct OpMix {
+    double searchHit;
+    double searchMiss;
+    double insert;
+    double remove;
+};
+
+struct WorkloadOp {
+    OpKind kind;
+    long long key;  // Corpus key (absent key for OP_SEARCH_MISS)
+};
+
+// YCSB-style operation stream over a URLCorpus whose keys [0, loaded) are
+// already in the table. Inserts add the next new key and deletes remove the
+// oldest stored one, so the stored keys are always a window
+// [firstLive, nextKey). Search hits pick a stored key by Zipfian or uniform
+// popularity over the first loaded keys; popular keys are scattered over
+// the key space (hashed ranks, like YCSB's scrambled Zipfian), and a hot
+// key's popularity moves to another stored key once it is deleted.
+// Misses use absent URLs. A hit or delete with nothing stored becomes a miss
+class OperationStream {
+private:
+    const URLCorpus& corpus;
+    double cumulative[NUM_OP_KINDS];
+    bool zipfian;
+    ZipfianGenerator popularity;
+    long long domain;  // Keys popularity ranks map onto: the first loaded
+    unsigned long long state;
+    long long firstLive;
+    long long nextKey;
+    
+    unsigned long long nextRandom();
+    double nextUniform();
+
+public:
+    // theta is ignored unless zipf
+    OperationStream(const URLCorpus& source, long long loaded, const OpMix& mix,
+                    bool zipf, double theta, unsigned long long streamSeed);
+    
+    WorkloadOp next();
+    void url(const WorkloadOp& op, string& out) const;
+    
+    long long getStored() const;  // Keys stored after the ops so far
+};
+
+#endif
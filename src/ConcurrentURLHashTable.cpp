@@ -0,0 +1,350 @@
+#include "../include/ConcurrentURLHashTable.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <iostream>
+
+//Slot value of a deleted key: a unique address that is never dereferenced
+static char deletedMarker;
+#define DELETED_KEY ((KeyNode*)&deletedMarker)
+
+ConcurrentURLHashTable::ConcurrentURLHashTable(int tableSize){
+    size = tableSize>0 ? tableSize : 1;
+    reducer = SlotReducer(size, REDUCE_MOD);
+    slots = new atomic<KeyNode*>[size];
+    for(int i=0; i<size; i++){
+        slots[i].store(0, memory_order_relaxed);
+    }
+    
+    threadStats = new ThreadStats[EpochReclaimer::MAX_THREADS];
+    for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+        threadStats[i].inserted = 0;
+        threadStats[i].removed = 0;
+    }
+    removedAtCompaction = 0;
+    
+    current_hType = BITWISE_HASH;
+    hashAlgo = &HashRegistry::find(current_hType);
+    observer = 0;
+}
+
+ConcurrentURLHashTable::~ConcurrentURLHashTable(){
+    for(int i=0; i<size; i++){
+        KeyNode* node = slots[i].load(memory_order_relaxed);
+        if(node && node!=DELETED_KEY){
+            freeNode(node);
+        }
+    }
+    delete[] slots;
+    delete[] threadStats;
+}
+
+ConcurrentURLHashTable::KeyNode* ConcurrentURLHashTable::makeNode(const string& url, unsigned long long hash){
+    KeyNode* node = (KeyNode*)malloc(sizeof(KeyNode)+url.length());
+    node->hash = hash;
+    node->len = url.length();
+    memcpy(node->bytes, url.data(), url.length());
+    return node;
+}
+
+void ConcurrentURLHashTable::freeNode(void* node){
+    free(node);
+}
+
+//Hash and length settle most mismatches without touching the key bytes
+bool ConcurrentURLHashTable::matches(const KeyNode* node, const string& url, unsigned long long hash, int& avoided) const{
+    if(node->hash!=hash || node->len!=url.length()){
+        avoided++;
+        return false;
+    }
+    return memcmp(node->bytes, url.data(), url.length())==0;
+}
+
+//Clears the slots and puts every live key back at the first EMPTY slot on
+//its path (recomputing its hash first if rehash is set). Quiescent
+void ConcurrentURLHashTable::placeAll(bool rehash){
+    vector<KeyNode*> nodes;
+    for(int i=0; i<size; i++){
+        KeyNode* node = slots[i].load(memory_order_relaxed);
+        if(node && node!=DELETED_KEY){
+            nodes.push_back(node);
+        }
+        slots[i].store(0, memory_order_relaxed);
+    }
+    
+    for(size_t i=0; i<nodes.size(); i++){
+        if(rehash){
+            nodes[i]->hash = hashAlgo->hash64(hashFunc, nodes[i]->bytes, nodes[i]->len);
+        }
+        int idx = reducer.reduce(nodes[i]->hash);
+        while(slots[idx].load(memory_order_relaxed)){
+            idx = idx+1<size ? idx+1 : 0;
+        }
+        slots[idx].store(nodes[i], memory_order_relaxed);
+    }
+    
+    reclaimer.drain();
+    removedAtCompaction = 0;
+    for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+        removedAtCompaction += threadStats[i].removed;
+    }
+}
+
+void ConcurrentURLHashTable::setHashFunction(HashType hashType){
+    if(hashType!=current_hType){
+        current_hType = hashType;
+        hashAlgo = &HashRegistry::find(hashType);
+        placeAll(true);
+    }
+}
+
+bool ConcurrentURLHashTable::setTimerSource(TimerSource source){
+    for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+        if(!threadStats[i].timer.setSource(source)){
+            return false;
+        }
+    }
+    return true;
+}
+
+void ConcurrentURLHashTable::setSampleInterval(int every){
+    for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+        threadStats[i].timer.setSampleInterval(every);
+    }
+}
+
+void ConcurrentURLHashTable::setObserver(TableObserver* tableObserver){
+    observer = tableObserver;
+}
+
+OpResult ConcurrentURLHashTable::search(const string& url){
+    ThreadStats& mine = threadStats[EpochReclaimer::threadIndex()];
+    bool timed = mine.timer.sample();
+    unsigned long long start = timed ? mine.timer.now() : 0;
+    OpResult result;
+    int avoided = 0;
+    unsigned long long hash = hashAlgo->hash64(hashFunc, url.data(), url.length());
+    
+    reclaimer.enter();
+    int idx = reducer.reduce(hash);
+    for(int i=0; i<size; i++){
+        KeyNode* current = slots[idx].load(memory_order_acquire);
+        if(!current){
+            break;  //Never claimed, so the URL is not further along
+        }
+        if(current!=DELETED_KEY){
+            result.probes++;  //Count slot comparison
+            if(matches(current, url, hash, avoided)){
+                result.slot = idx;
+                result.success = true;
+                break;
+            }
+        }
+        idx = idx+1<size ? idx+1 : 0;
+    }
+    reclaimer.exit();
+    
+    OpKind kind = result.success ? OP_SEARCH_HIT : OP_SEARCH_MISS;
+    if(timed){
+        result.elapsed = mine.timer.seconds(start, mine.timer.now());
+        mine.stats.recordTime(kind, result.elapsed);
+    }
+    mine.stats.recordQuery(kind, result.probes);
+    mine.stats.recordAvoidedCompares(avoided);
+    return result;
+}
+
+//The key node is built only once an EMPTY slot is reached, and freed again
+//if another thread turns out to have inserted the same URL
+OpResult ConcurrentURLHashTable::insert(const string& url){
+    ThreadStats& mine = threadStats[EpochReclaimer::threadIndex()];
+    bool timed = mine.timer.sample();
+    unsigned long long start = timed ? mine.timer.now() : 0;
+    OpResult result;
+    int avoided = 0;
+    unsigned long long hash = hashAlgo->hash64(hashFunc, url.data(), url.length());
+    KeyNode* node = 0;
+    
+    reclaimer.enter();
+    int idx = reducer.reduce(hash);
+    for(int i=0; i<size; i++){
+        KeyNode* current = slots[idx].load(memory_order_acquire);
+        if(!current){
+            if(!node){
+                node = makeNode(url, hash);
+            }
+            if(slots[idx].compare_exchange_strong(current, node, memory_order_acq_rel, memory_order_acquire)){
+                result.slot = idx;
+                result.success = true;
+                break;
+            }
+            //Lost the slot: current now holds the winning key
+        }
+        if(current!=DELETED_KEY){
+            result.probes++;  //Count slot comparison
+            if(matches(current, url, hash, avoided)){
+                result.slot = idx;
+                break;
+            }
+        }
+        idx = idx+1<size ? idx+1 : 0;
+    }
+    reclaimer.exit();
+    
+    if(result.success){
+        mine.inserted.fetch_add(1, memory_order_relaxed);
+    }
+    else if(node){
+        freeNode(node);  //Never published
+    }
+    
+    if(timed){
+        result.elapsed = mine.timer.seconds(start, mine.timer.now());
+        mine.stats.recordTime(OP_INSERT, result.elapsed);
+    }
+    mine.stats.recordQuery(OP_INSERT, result.probes);
+    mine.stats.recordAvoidedCompares(avoided);
+    return result;
+}
+
+//The key is unlinked by CASing its slot to DELETED and freed once no
+//reader can still hold it. A failed CAS means another thread deleted it
+//first; the probe goes on in case the URL was inserted again further along
+OpResult ConcurrentURLHashTable::remove(const string& url){
+    ThreadStats& mine = threadStats[EpochReclaimer::threadIndex()];
+    bool timed = mine.timer.sample();
+    unsigned long long start = timed ? mine.timer.now() : 0;
+    OpResult result;
+    int avoided = 0;
+    unsigned long long hash = hashAlgo->hash64(hashFunc, url.data(), url.length());
+    
+    reclaimer.enter();
+    int idx = reducer.reduce(hash);
+    for(int i=0; i<size; i++){
+        KeyNode* current = slots[idx].load(memory_order_acquire);
+        if(!current){
+            break;
+        }
+        if(current!=DELETED_KEY){
+            result.probes++;  //Count slot comparison
+            if(matches(current, url, hash, avoided) &&
+               slots[idx].compare_exchange_strong(current, DELETED_KEY, memory_order_acq_rel, memory_order_acquire)){
+                reclaimer.retire(current, freeNode);
+                result.slot = idx;
+                result.success = true;
+                break;
+            }
+        }
+        idx = idx+1<size ? idx+1 : 0;
+    }
+    reclaimer.exit();
+    
+    if(result.success){
+        mine.removed.fetch_add(1, memory_order_relaxed);
+    }
+    
+    if(timed){
+        result.elapsed = mine.timer.seconds(start, mine.timer.now());
+        mine.stats.recordTime(OP_DELETE, result.elapsed);
+    }
+    mine.stats.recordQuery(OP_DELETE, result.probes);
+    mine.stats.recordAvoidedCompares(avoided);
+    return result;
+}
+
+bool ConcurrentURLHashTable::searchURL(const string& url){
+    OpResult result = search(url);
+    if(observer){
+        observer->onSearch(url, result);
+    }
+    return result.success;
+}
+
+bool ConcurrentURLHashTable::insertURL(const string& url){
+    OpResult result = insert(url);
+    if(observer){
+        observer->onInsert(url, result);
+    }
+    return result.success;
+}
+
+bool ConcurrentURLHashTable::deleteURL(const string& url){
+    OpResult result = remove(url);
+    if(observer){
+        observer->onDelete(url, result);
+    }
+    return result.success;
+}
+
+void ConcurrentURLHashTable::compactTombstones(){
+    ThreadStats& mine = threadStats[EpochReclaimer::threadIndex()];
+    unsigned long long start = mine.timer.now();
+    int removed = getNumTombstones();
+    
+    placeAll(false);
+    
+    //Keys are separate allocations, so there are no arena bytes to report
+    mine.stats.recordCompaction(removed, 0, mine.timer.seconds(start, mine.timer.now()));
+}
+
+void ConcurrentURLHashTable::displayStats(){
+    cout << "HASH STATS" << endl;
+    
+    cout << "\nConfiguration:" << endl;
+    cout << "Hash Function: " << hashAlgo->name << endl;
+    cout << "Probing Method: Linear Probing (lock-free, CAS-published slots)" << endl;
+    
+    Statistics merged = getStats();
+    merged.display(size, getNumElements(), getLoadFactor(), current_hType);
+    merged.displayCompares();
+    merged.displayPercentiles();
+    merged.displayTombstones(getNumTombstones(), size, 0);
+    
+    cout << "\nReclamation Metrics:" << endl;
+    cout << "Global epoch: " << reclaimer.getEpoch() << endl;
+    cout << "Deleted keys freed: " << reclaimer.getFreed() << endl;
+    cout << "Deleted keys awaiting a safe epoch: " << reclaimer.getPending() << endl;
+}
+
+void ConcurrentURLHashTable::resetStats(){
+    for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+        threadStats[i].stats.reset();
+    }
+}
+
+double ConcurrentURLHashTable::getLoadFactor(){
+    return (double)getNumElements()/size;
+}
+
+int ConcurrentURLHashTable::getSize(){
+    return size;
+}
+
+int ConcurrentURLHashTable::getNumElements(){
+    long total = 0;
+    for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+        total += threadStats[i].inserted.load(memory_order_relaxed);
+        total -= threadStats[i].removed.load(memory_order_relaxed);
+    }
+    return (int)total;
+}
+
+int ConcurrentURLHashTable::getNumTombstones(){
+    long total = 0;
+    for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+        total += threadStats[i].removed.load(memory_order_relaxed);
+    }
+    return (int)(total-removedAtCompaction);
+}
+
+long ConcurrentURLHashTable::getPendingReclaim() const{
+    return reclaimer.getPending();
+}
+
+Statistics ConcurrentURLHashTable::getStats(){
+    Statistics merged;
+    for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+        merged.merge(threadStats[i].stats);
+    }
+    return merged;
+}
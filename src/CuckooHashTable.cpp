@@ -0,0 +1,392 @@
+#include "../include/CuckooHashTable.h"
+#include <iostream>
+#include <cstdint>
+#include <new>
+
+const int CuckooHashTable::BUCKET_SLOTS;
+const int CuckooHashTable::MAX_SEARCH_BUCKETS;
+const unsigned char CuckooHashTable::TAG_EMPTY;
+const int CuckooHashTable::CACHE_LINE;
+const int CuckooHashTable::KEY_LENGTH_BITS;
+const unsigned long long CuckooHashTable::MAX_KEY_LENGTH;
+
+//The second hash must not share the first one's collisions, so it comes
+//from another HashFunctions family: universalHash64 (random coefficients),
+//or polynomialHash64 when the first hash is already universal
+static HashType secondHashFor(HashType hashType){
+    if(hashType==UNIVERSAL_HASH || hashType==UNIVERSAL_WIDE_HASH){
+        return POLYNOMIAL_HASH;
+    }
+    return UNIVERSAL_HASH;
+}
+
+CuckooHashTable::CuckooHashTable(int tableSize){
+    numBuckets = (tableSize+BUCKET_SLOTS-1)/BUCKET_SLOTS;
+    if(numBuckets<1){
+        numBuckets = 1;
+    }
+    size = numBuckets*BUCKET_SLOTS;
+    bucketReducer = SlotReducer(numBuckets, REDUCE_MOD);
+    numElements = 0;
+    relocations = 0;
+    longestPath = 0;
+    failedInserts = 0;
+    
+    //new only guarantees the alignment of fundamental types, so allocate a
+    //line extra and start the array at the first line boundary
+    bucketMemory = new char[numBuckets*sizeof(Bucket) + CACHE_LINE-1];
+    uintptr_t base = reinterpret_cast<uintptr_t>(bucketMemory);
+    buckets = reinterpret_cast<Bucket*>((base+CACHE_LINE-1) & ~(uintptr_t)(CACHE_LINE-1));
+    for(int b=0; b<numBuckets; b++){
+        new (&buckets[b]) Bucket();
+        for(int i=0; i<BUCKET_SLOTS; i++){
+            buckets[b].tags[i] = TAG_EMPTY;
+        }
+    }
+    queue.reserve(MAX_SEARCH_BUCKETS);
+    observer = 0;
+    setHashFunction(BITWISE_HASH);
+}
+
+CuckooHashTable::~CuckooHashTable(){
+    delete[] bucketMemory;
+}
+
+void CuckooHashTable::setHashFunction(HashType hashType){
+    current_hType = hashType;
+    hashAlgo = &HashRegistry::find(hashType);
+    secondAlgo = &HashRegistry::find(secondHashFor(hashType));
+}
+
+bool CuckooHashTable::setTimerSource(TimerSource source){
+    return timer.setSource(source);
+}
+
+void CuckooHashTable::setSampleInterval(int every){
+    timer.setSampleInterval(every);
+}
+
+void CuckooHashTable::setObserver(TableObserver* tableObserver){
+    observer = tableObserver;
+}
+
+//Both candidate buckets and the slot fingerprint. The fingerprint mixes
+//both hashes so it stays the same in either bucket
+void CuckooHashTable::hashURL(const string& url, int& first, int& second, unsigned char& tag){
+    unsigned long long h1 = hashAlgo->hash64(hashFunc, url.data(), url.length());
+    unsigned long long h2 = secondAlgo->hash64(hashFunc, url.data(), url.length());
+    first = bucketReducer.reduce(h1);
+    second = bucketReducer.reduce(h2);
+    
+    //Two distinct buckets whenever there are two, so no URL has only 4 slots
+    if(second==first && numBuckets>1){
+        second = first+1<numBuckets ? first+1 : 0;
+    }
+    
+    tag = (unsigned char)(((h1 ^ h2)*0x9E3779B97F4A7C15ULL) >> 56);
+    if(tag==TAG_EMPTY){
+        tag = 1;
+    }
+}
+
+//Only slots with a matching fingerprint reach the arena
+int CuckooHashTable::findInBucket(int bucket, const string& url, unsigned char tag, int& comp) const{
+    const Bucket& b = buckets[bucket];
+    for(int i=0; i<BUCKET_SLOTS; i++){
+        if(b.tags[i]==tag){
+            comp++;  //Count URL string comparison
+            if(keyLength(b.keys[i])==url.length() && arena.equals(keyOffset(b.keys[i]), url)){
+                return bucket*BUCKET_SLOTS+i;
+            }
+        }
+    }
+    return -1;
+}
+
+//Returns the slot holding url, or -1. Never looks past the two buckets
+int CuckooHashTable::findSlot(const string& url, int first, int second, unsigned char tag, int& comp) const{
+    int idx = findInBucket(first, url, tag, comp);
+    if(idx==-1 && second!=first){
+        idx = findInBucket(second, url, tag, comp);
+    }
+    return idx;
+}
+
+int CuckooHashTable::freeSlot(int bucket) const{
+    const Bucket& b = buckets[bucket];
+    for(int i=0; i<BUCKET_SLOTS; i++){
+        if(b.tags[i]==TAG_EMPTY){
+            return bucket*BUCKET_SLOTS+i;
+        }
+    }
+    return -1;
+}
+
+//Whether bucket is already on the path from the new URL to queue[node]. A
+//path that visits a bucket twice would move an entry onto one it just moved
+bool CuckooHashTable::onPath(int node, int bucket) const{
+    for(int n=node; n!=-1; n=queue[n].parent){
+        if(queue[n].bucket==bucket){
+            return true;
+        }
+    }
+    return false;
+}
+
+//Breadth-first search from both full candidate buckets: each step moves one
+//resident to its other bucket, so the first bucket found with a free slot
+//ends the shortest chain. The chain is applied from its free end back, and
+//the freed slot in first or second is returned (-1 if the search gave up)
+int CuckooHashTable::makeRoom(int first, int second){
+    queue.clear();
+    PathNode root = {first, -1, -1, 0};
+    queue.push_back(root);
+    if(second!=first){
+        root.bucket = second;
+        queue.push_back(root);
+    }
+    
+    for(size_t head=0; head<queue.size(); head++){
+        int hole = freeSlot(queue[head].bucket);
+        if(hole!=-1){
+            if(queue[head].depth>longestPath){
+                longestPath = queue[head].depth;
+            }
+            //Only the slot (tag, key reference, other bucket) moves; the key bytes
+            //stay in the arena
+            for(int n=(int)head; queue[n].parent!=-1; n=queue[n].parent){
+                int fromBucket = queue[queue[n].parent].bucket;
+                Bucket& src = buckets[fromBucket];
+                Bucket& dst = buckets[hole/BUCKET_SLOTS];
+                int s = queue[n].slot;
+                int d = hole%BUCKET_SLOTS;
+                dst.tags[d] = src.tags[s];
+                dst.keys[d] = src.keys[s];
+                dst.alt[d] = fromBucket;
+                src.tags[s] = TAG_EMPTY;
+                relocations++;
+                hole = fromBucket*BUCKET_SLOTS + s;
+            }
+            return hole;
+        }
+        
+        const Bucket& b = buckets[queue[head].bucket];
+        for(int i=0; i<BUCKET_SLOTS && (int)queue.size()<MAX_SEARCH_BUCKETS; i++){
+            int alt = b.alt[i];
+            if(alt==queue[head].bucket || onPath((int)head, alt)){
+                continue;
+            }
+            PathNode next = {alt, (int)head, i, queue[head].depth+1};
+            queue.push_back(next);
+        }
+    }
+    
+    return -1;
+}
+
+void CuckooHashTable::place(int idx, const string& url, unsigned char tag, int other){
+    Bucket& b = buckets[idx/BUCKET_SLOTS];
+    int i = idx%BUCKET_SLOTS;
+    unsigned long long offset = arena.append(url);
+    b.tags[i] = tag;
+    b.keys[i] = (offset << KEY_LENGTH_BITS) | url.length();
+    b.alt[i] = other;
+    numElements++;
+}
+
+//Repacks the live keys into a new arena, dropping deleted keys' bytes
+void CuckooHashTable::reclaimKeys(){
+    KeyArena packed;
+    packed.reserve(arena.size()-arena.getDeadBytes());
+    
+    for(int bucket=0; bucket<numBuckets; bucket++){
+        Bucket& b = buckets[bucket];
+        for(int i=0; i<BUCKET_SLOTS; i++){
+            if(b.tags[i]!=TAG_EMPTY){
+                unsigned int len = keyLength(b.keys[i]);
+                unsigned long long offset = packed.append(arena.data(keyOffset(b.keys[i])), len);
+                b.keys[i] = (offset << KEY_LENGTH_BITS) | len;
+            }
+        }
+    }
+    arena.swap(packed);
+}
+
+OpResult CuckooHashTable::search(const string& url){
+    bool timed = timer.sample();
+    unsigned long long start = timed ? timer.now() : 0;
+    OpResult result;
+    
+    int first, second;
+    unsigned char tag;
+    hashURL(url, first, second, tag);
+    result.slot = findSlot(url, first, second, tag, result.probes);
+    result.success = result.slot!=-1;
+    
+    OpKind kind = result.success ? OP_SEARCH_HIT : OP_SEARCH_MISS;
+    if(timed){
+        result.elapsed = timer.seconds(start, timer.now());
+        stats.recordTime(kind, result.elapsed);
+    }
+    stats.recordQuery(kind, result.probes);
+    return result;
+}
+
+OpResult CuckooHashTable::insert(const string& url){
+    bool timed = timer.sample();
+    unsigned long long start = timed ? timer.now() : 0;
+    OpResult result;
+    
+    int first, second;
+    unsigned char tag;
+    hashURL(url, first, second, tag);
+    result.slot = findSlot(url, first, second, tag, result.probes);
+    
+    if(result.slot==-1 && numElements<size && url.length()<=MAX_KEY_LENGTH){
+        int idx = freeSlot(first);
+        if(idx==-1){
+            idx = freeSlot(second);
+        }
+        if(idx==-1){
+            idx = makeRoom(first, second);
+        }
+        
+        if(idx!=-1){
+            place(idx, url, tag, idx/BUCKET_SLOTS==first ? second : first);
+            result.success = true;
+            result.slot = idx;
+        }
+        else{
+            failedInserts++;
+        }
+    }
+    else if(result.slot==-1){
+        failedInserts++;
+    }
+    
+    if(timed){
+        result.elapsed = timer.seconds(start, timer.now());
+        stats.recordTime(OP_INSERT, result.elapsed);
+    }
+    stats.recordQuery(OP_INSERT, result.probes);
+    return result;
+}
+
+OpResult CuckooHashTable::remove(const string& url){
+    bool timed = timer.sample();
+    unsigned long long start = timed ? timer.now() : 0;
+    OpResult result;
+    
+    int first, second;
+    unsigned char tag;
+    hashURL(url, first, second, tag);
+    result.slot = findSlot(url, first, second, tag, result.probes);
+    
+    //No probe sequence runs through a bucket, so the slot is simply freed.
+    //The arena is repacked once deleted keys make up half of it
+    if(result.slot!=-1){
+        Bucket& b = buckets[result.slot/BUCKET_SLOTS];
+        int i = result.slot%BUCKET_SLOTS;
+        b.tags[i] = TAG_EMPTY;
+        arena.release(keyLength(b.keys[i]));
+        numElements--;
+        result.success = true;
+        if(arena.getDeadBytes()*2 > arena.size()){
+            reclaimKeys();
+        }
+    }
+    
+    if(timed){
+        result.elapsed = timer.seconds(start, timer.now());
+        stats.recordTime(OP_DELETE, result.elapsed);
+    }
+    stats.recordQuery(OP_DELETE, result.probes);
+    return result;
+}
+
+bool CuckooHashTable::searchURL(const string& url){
+    OpResult result = search(url);
+    if(observer){
+        observer->onSearch(url, result);
+    }
+    return result.success;
+}
+
+bool CuckooHashTable::insertURL(const string& url){
+    OpResult result = insert(url);
+    if(observer){
+        observer->onInsert(url, result);
+    }
+    return result.success;
+}
+
+bool CuckooHashTable::deleteURL(const string& url){
+    OpResult result = remove(url);
+    if(observer){
+        observer->onDelete(url, result);
+    }
+    return result.success;
+}
+
+void CuckooHashTable::displayStats(){
+    cout << "HASH STATS" << endl;
+    
+    cout << "\nConfiguration:" << endl;
+    cout << "Hash Function: " << hashAlgo->name << endl;
+    cout << "Second Hash Function: " << secondAlgo->name << endl;
+    
+    cout << "Probing Method: Cuckoo (2 buckets of " << BUCKET_SLOTS << " slots)" << endl;
+    
+    stats.display(size, numElements, getLoadFactor(), current_hType);
+    cout << "Relocations: " << relocations << ", longest eviction path: " << longestPath
+         << ", failed inserts: " << failedInserts << endl;
+    
+    //Compared with a tag, a std::string and an other-bucket index per slot
+    long slotBytes = (long)numBuckets*sizeof(Bucket);
+    long stringBytes = (long)size*(1+sizeof(string)+sizeof(int));
+    size_t inlineCapacity = string().capacity();
+    for(int bucket=0; bucket<numBuckets; bucket++){
+        for(int i=0; i<BUCKET_SLOTS; i++){
+            if(buckets[bucket].tags[i]!=TAG_EMPTY && keyLength(buckets[bucket].keys[i])>inlineCapacity){
+                stringBytes += keyLength(buckets[bucket].keys[i])+1;
+            }
+        }
+    }
+    stats.displayKeyStorage(numElements, slotBytes, arena.capacity(), arena.getDeadBytes(), stringBytes);
+    stats.displayPercentiles();
+}
+
+void CuckooHashTable::resetStats(){
+    stats.reset();
+    relocations = 0;
+    longestPath = 0;
+    failedInserts = 0;
+}
+
+double CuckooHashTable::getLoadFactor(){
+    return (double)numElements/size;
+}
+
+int CuckooHashTable::getSize(){
+    return size;
+}
+
+int CuckooHashTable::getNumElements(){
+    return numElements;
+}
+
+long long CuckooHashTable::getRelocations() const{
+    return relocations;
+}
+
+int CuckooHashTable::getLongestPath() const{
+    return longestPath;
+}
+
+long CuckooHashTable::getFailedInserts() const{
+    return failedInserts;
+}
+
+const Statistics& CuckooHashTable::getStats() const{
+    return stats;
+}
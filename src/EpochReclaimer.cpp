@@ -0,0 +1,144 @@
+#include "../include/EpochReclaimer.h"
+#include <mutex>
+#include <thread>
+
+const int EpochReclaimer::MAX_THREADS;
+
+//Retirements between attempts to advance the epoch and free old nodes
+static const size_t RECLAIM_BATCH = 64;
+
+static mutex indexLock;
+static bool indexUsed[EpochReclaimer::MAX_THREADS];
+
+//Holds a thread's index for as long as the thread runs. If every index is
+//taken the thread waits for one to be released
+struct ThreadIndex {
+    int id;
+    
+    ThreadIndex(){
+        id = -1;
+        while(id==-1){
+            {
+                lock_guard<mutex> guard(indexLock);
+                for(int i=0; i<EpochReclaimer::MAX_THREADS; i++){
+                    if(!indexUsed[i]){
+                        indexUsed[i] = true;
+                        id = i;
+                        break;
+                    }
+                }
+            }
+            if(id==-1){
+                this_thread::yield();
+            }
+        }
+    }
+    
+    ~ThreadIndex(){
+        lock_guard<mutex> guard(indexLock);
+        indexUsed[id] = false;
+    }
+};
+
+int EpochReclaimer::threadIndex(){
+    static thread_local ThreadIndex index;
+    return index.id;
+}
+
+EpochReclaimer::EpochReclaimer(){
+    globalEpoch = 0;
+    numRetired = 0;
+    numFreed = 0;
+    records = new Record[MAX_THREADS];
+    for(int i=0; i<MAX_THREADS; i++){
+        records[i].state = 0;
+    }
+}
+
+EpochReclaimer::~EpochReclaimer(){
+    drain();
+    delete[] records;
+}
+
+//Announce the current epoch. Re-checking the global epoch after the store
+//guarantees the announced epoch was current once the announcement was visible
+void EpochReclaimer::enter(){
+    Record& record = records[threadIndex()];
+    unsigned long long epoch;
+    do{
+        epoch = globalEpoch.load();
+        record.state.store((epoch << 1) | 1);
+    } while(globalEpoch.load()!=epoch);
+}
+
+void EpochReclaimer::exit(){
+    Record& record = records[threadIndex()];
+    record.state.store(record.state.load(memory_order_relaxed) & ~1ULL);
+}
+
+//The epoch moves on only once every thread inside a critical section has
+//announced the current one
+bool EpochReclaimer::tryAdvance(){
+    unsigned long long epoch = globalEpoch.load();
+    for(int i=0; i<MAX_THREADS; i++){
+        unsigned long long state = records[i].state.load();
+        if((state & 1) && (state >> 1)!=epoch){
+            return false;
+        }
+    }
+    return globalEpoch.compare_exchange_strong(epoch, epoch+1);
+}
+
+//Readers that could have reached a node entered no later than the epoch it
+//was retired in; two advances later all of them have left
+void EpochReclaimer::reclaim(Record& record, unsigned long long epoch){
+    size_t kept = 0;
+    for(size_t i=0; i<record.limbo.size(); i++){
+        Retired& item = record.limbo[i];
+        if(item.epoch+2<=epoch){
+            item.deleter(item.node);
+            numFreed++;
+        }
+        else{
+            record.limbo[kept++] = item;
+        }
+    }
+    record.limbo.resize(kept);
+}
+
+void EpochReclaimer::retire(void* node, Deleter deleter){
+    Record& record = records[threadIndex()];
+    Retired item;
+    item.node = node;
+    item.deleter = deleter;
+    item.epoch = globalEpoch.load();
+    record.limbo.push_back(item);
+    numRetired++;
+    
+    if(record.limbo.size()%RECLAIM_BATCH==0){
+        tryAdvance();
+        reclaim(record, globalEpoch.load());
+    }
+}
+
+void EpochReclaimer::drain(){
+    for(int i=0; i<MAX_THREADS; i++){
+        for(size_t j=0; j<records[i].limbo.size(); j++){
+            records[i].limbo[j].deleter(records[i].limbo[j].node);
+            numFreed++;
+        }
+        records[i].limbo.clear();
+    }
+}
+
+long EpochReclaimer::getPending() const{
+    return numRetired-numFreed;
+}
+
+long EpochReclaimer::getFreed() const{
+    return numFreed;
+}
+
+unsigned long long EpochReclaimer::getEpoch() const{
+    return globalEpoch;
+}
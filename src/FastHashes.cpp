@@ -0,0 +1,349 @@
+#include "../include/FastHashes.h"
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <nmmintrin.h>
+#define FAST_HASH_X86_CRC 1
+#endif
+
+static inline unsigned long long rotl64(unsigned long long x, int r){
+    return (x << r) | (x >> (64-r));
+}
+
+static inline unsigned long long read64(const char* p){
+    unsigned long long v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline unsigned long long read32(const char* p){
+    unsigned int v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+//xxHash64 (XXH64 reference algorithm)
+static const unsigned long long XXH_PRIME1 = 0x9E3779B185EBCA87ULL;
+static const unsigned long long XXH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const unsigned long long XXH_PRIME3 = 0x165667B19E3779F9ULL;
+static const unsigned long long XXH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const unsigned long long XXH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static inline unsigned long long xxhRound(unsigned long long acc, unsigned long long input){
+    acc += input * XXH_PRIME2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME1;
+}
+
+static inline unsigned long long xxhMerge(unsigned long long acc, unsigned long long val){
+    acc ^= xxhRound(0, val);
+    return acc * XXH_PRIME1 + XXH_PRIME4;
+}
+
+unsigned long long FastHashes::xxHash64(const char* key, size_t len, unsigned long long seed){
+    const char* p = key;
+    const char* end = key + len;
+    unsigned long long h;
+    
+    //Four independent lanes over 32-byte stripes
+    if(len >= 32){
+        unsigned long long v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+        unsigned long long v2 = seed + XXH_PRIME2;
+        unsigned long long v3 = seed;
+        unsigned long long v4 = seed - XXH_PRIME1;
+        const char* limit = end - 32;
+        do{
+            v1 = xxhRound(v1, read64(p));
+            v2 = xxhRound(v2, read64(p+8));
+            v3 = xxhRound(v3, read64(p+16));
+            v4 = xxhRound(v4, read64(p+24));
+            p += 32;
+        }while(p <= limit);
+        
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxhMerge(h, v1);
+        h = xxhMerge(h, v2);
+        h = xxhMerge(h, v3);
+        h = xxhMerge(h, v4);
+    }
+    else{
+        h = seed + XXH_PRIME5;
+    }
+    
+    h += len;
+    
+    while(p+8 <= end){
+        h ^= xxhRound(0, read64(p));
+        h = rotl64(h, 27) * XXH_PRIME1 + XXH_PRIME4;
+        p += 8;
+    }
+    if(p+4 <= end){
+        h ^= read32(p) * XXH_PRIME1;
+        h = rotl64(h, 23) * XXH_PRIME2 + XXH_PRIME3;
+        p += 4;
+    }
+    while(p < end){
+        h ^= (unsigned char)*p * XXH_PRIME5;
+        h = rotl64(h, 11) * XXH_PRIME1;
+        p++;
+    }
+    
+    //Avalanche
+    h ^= h >> 33;
+    h *= XXH_PRIME2;
+    h ^= h >> 29;
+    h *= XXH_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+//wyhash (version final3, default secret)
+static const unsigned long long WY_SECRET[4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+};
+
+//64x64 -> 128-bit multiply, low half into a and high half into b
+static inline void wyMum(unsigned long long& a, unsigned long long& b){
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    a = (unsigned long long)r;
+    b = (unsigned long long)(r >> 64);
+#else
+    unsigned long long ha = a >> 32, hb = b >> 32, la = (unsigned int)a, lb = (unsigned int)b;
+    unsigned long long rh = ha*hb, rm0 = ha*lb, rm1 = hb*la, rl = la*lb;
+    unsigned long long t = rl + (rm0 << 32);
+    unsigned long long c = t < rl;
+    unsigned long long lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline unsigned long long wyMix(unsigned long long a, unsigned long long b){
+    wyMum(a, b);
+    return a ^ b;
+}
+
+//Reads 1-3 bytes: first, middle and last
+static inline unsigned long long wyRead3(const char* p, size_t k){
+    return ((unsigned long long)(unsigned char)p[0] << 16) |
+           ((unsigned long long)(unsigned char)p[k >> 1] << 8) |
+           (unsigned char)p[k-1];
+}
+
+unsigned long long FastHashes::wyhash(const char* key, size_t len, unsigned long long seed){
+    const char* p = key;
+    unsigned long long a, b;
+    seed ^= WY_SECRET[0];
+    
+    if(len <= 16){
+        if(len >= 4){
+            size_t off = (len >> 3) << 2;
+            a = (read32(p) << 32) | read32(p+off);
+            b = (read32(p+len-4) << 32) | read32(p+len-4-off);
+        }
+        else if(len > 0){
+            a = wyRead3(p, len);
+            b = 0;
+        }
+        else{
+            a = b = 0;
+        }
+    }
+    else{
+        size_t i = len;
+        if(i > 48){
+            unsigned long long see1 = seed, see2 = seed;
+            do{
+                seed = wyMix(read64(p) ^ WY_SECRET[1], read64(p+8) ^ seed);
+                see1 = wyMix(read64(p+16) ^ WY_SECRET[2], read64(p+24) ^ see1);
+                see2 = wyMix(read64(p+32) ^ WY_SECRET[3], read64(p+40) ^ see2);
+                p += 48;
+                i -= 48;
+            }while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16){
+            seed = wyMix(read64(p) ^ WY_SECRET[1], read64(p+8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read64(p+i-16);
+        b = read64(p+i-8);
+    }
+    
+    return wyMix(WY_SECRET[1] ^ len, wyMix(a ^ WY_SECRET[1], b ^ seed));
+}
+
+//FNV-1a, 64-bit. A non-zero seed is folded into the offset basis
+unsigned long long FastHashes::fnv1a64(const char* key, size_t len, unsigned long long seed){
+    unsigned long long h = 0xcbf29ce484222325ULL ^ seed;
+    for(size_t i=0; i<len; i++){
+        h ^= (unsigned char)key[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static inline unsigned long long murmurFmix(unsigned long long k){
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+unsigned long long FastHashes::murmur3(const char* key, size_t len, unsigned long long seed){
+    const unsigned long long c1 = 0x87c37b91114253d5ULL;
+    const unsigned long long c2 = 0x4cf5ad432745937fULL;
+    unsigned long long h1 = seed, h2 = seed;
+    size_t nblocks = len / 16;
+    
+    for(size_t i=0; i<nblocks; i++){
+        unsigned long long k1 = read64(key + i*16);
+        unsigned long long k2 = read64(key + i*16 + 8);
+        
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1*5 + 0x52dce729;
+        
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2*5 + 0x38495ab5;
+    }
+    
+    //Up to 15 trailing bytes, packed little-endian into k1 (bytes 0-7) and k2
+    const unsigned char* tail = (const unsigned char*)(key + nblocks*16);
+    size_t rem = len & 15;
+    unsigned long long k1 = 0, k2 = 0;
+    for(size_t i=rem; i>8; i--){
+        k2 |= (unsigned long long)tail[i-1] << ((i-9)*8);
+    }
+    for(size_t i=(rem<8 ? rem : 8); i>0; i--){
+        k1 |= (unsigned long long)tail[i-1] << ((i-1)*8);
+    }
+    if(rem > 8){
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+    }
+    if(rem > 0){
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+    
+    h1 ^= len;
+    h2 ^= len;
+    h1 += h2;
+    h2 += h1;
+    h1 = murmurFmix(h1);
+    h2 = murmurFmix(h2);
+    h1 += h2;
+    return h1;
+}
+
+//CRC32C lookup tables for slicing-by-8: table[0] is the classic byte table
+//for the reflected Castagnoli polynomial, table[j] advances j more zero bytes
+struct Crc32cTables {
+    unsigned int table[8][256];
+    
+    Crc32cTables(){
+        for(unsigned int i=0; i<256; i++){
+            unsigned int crc = i;
+            for(int bit=0; bit<8; bit++){
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+            }
+            table[0][i] = crc;
+        }
+        for(unsigned int i=0; i<256; i++){
+            for(int j=1; j<8; j++){
+                table[j][i] = (table[j-1][i] >> 8) ^ table[0][table[j-1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+static const Crc32cTables& crc32cTables(){
+    static const Crc32cTables tables;
+    return tables;
+}
+
+//Raw CRC update (no pre/post inversion), eight bytes per step
+unsigned int FastHashes::crc32cSoftware(const char* key, size_t len, unsigned int crc){
+    const unsigned int (*t)[256] = crc32cTables().table;
+    const unsigned char* p = (const unsigned char*)key;
+    
+    while(len >= 8){
+        unsigned long long v = read64((const char*)p) ^ crc;
+        crc = t[7][v & 0xFF] ^ t[6][(v >> 8) & 0xFF] ^
+              t[5][(v >> 16) & 0xFF] ^ t[4][(v >> 24) & 0xFF] ^
+              t[3][(v >> 32) & 0xFF] ^ t[2][(v >> 40) & 0xFF] ^
+              t[1][(v >> 48) & 0xFF] ^ t[0][v >> 56];
+        p += 8;
+        len -= 8;
+    }
+    while(len > 0){
+        crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+        p++;
+        len--;
+    }
+    return crc;
+}
+
+#ifdef FAST_HASH_X86_CRC
+__attribute__((target("sse4.2")))
+unsigned int FastHashes::crc32cHardware(const char* key, size_t len, unsigned int crc){
+    unsigned long long c = crc;
+    while(len >= 8){
+        c = _mm_crc32_u64(c, read64(key));
+        key += 8;
+        len -= 8;
+    }
+    crc = (unsigned int)c;
+    while(len > 0){
+        crc = _mm_crc32_u8(crc, (unsigned char)*key);
+        key++;
+        len--;
+    }
+    return crc;
+}
+#else
+unsigned int FastHashes::crc32cHardware(const char* key, size_t len, unsigned int crc){
+    return crc32cSoftware(key, len, crc);
+}
+#endif
+
+bool FastHashes::crc32cHardwareSupported(){
+#ifdef FAST_HASH_X86_CRC
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return false;
+#endif
+}
+
+static bool& crc32cUseHardware(){
+    static bool enabled = FastHashes::crc32cHardwareSupported();
+    return enabled;
+}
+
+bool FastHashes::crc32cHardwareEnabled(){
+    return crc32cUseHardware();
+}
+
+bool FastHashes::setCrc32cHardware(bool enabled){
+    if(enabled && !crc32cHardwareSupported()){
+        return false;
+    }
+    crc32cUseHardware() = enabled;
+    return true;
+}
+
+//The seed's low 32 bits are the initial CRC (standard CRC32C for seed 0)
+unsigned long long FastHashes::crc32c(const char* key, size_t len, unsigned long long seed){
+    unsigned int crc = ~(unsigned int)seed;
+    if(crc32cUseHardware()){
+        crc = crc32cHardware(key, len, crc);
+    }
+    else{
+        crc = crc32cSoftware(key, len, crc);
+    }
+    return ~crc;
+}
@@ -1,3 +1,12 @@
 #include "../include/HashEntry.h"
 
-HashEntry::HashEntry() : url(""), status(EMPTY) {}
+HashEntry::HashEntry() : offset(0), hash(0), len(0), tag(0), status(EMPTY), dist(0) {}
+
+unsigned int HashEntry::tailTag(const string& url){
+    unsigned int tag = 0;
+    size_t start = url.size()>4 ? url.size()-4 : 0;
+    for(size_t i=start; i<url.size(); i++){
+        tag = (tag << 8) | (unsigned char)url[i];
+    }
+    return tag;
+}
@@ -1,20 +1,61 @@
 #include "../include/HashFunctions.h"
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define HASH_X86_KERNELS 1
+#endif
 
 HashFunctions::HashFunctions(){
     k = 1000003;  // Large odd prime
     a = 31415;    // Random value
     b = 27183;    // Random value
-}
-//Uses bit-level operations for speed and good distribution
-unsigned long HashFunctions::bitwiseHash(const string& url, int size){
-    unsigned long hash = 0;
     
-    //First pass: accumulate characters
-    for(size_t i = 0; i < url.length(); i++){
-        hash = hash * 31 + (unsigned char)url[i];
-    }
+    //Size-dependent tables are rebuilt on first use
+    buildPowers(bitwisePowers, 31, 0);
+    buildPowers(polyPowers, 31, 1);
+    buildPowers(universalPowers, 256, 1);
     
-    //Bitwise mixing for better distribution
+    a61 = 0x1F2E3D4C5B6A7988ULL;  // Random values below 2^61-1
+    b61 = 0x0A1B2C3D4E5F6071ULL;
+    buildPowers61(polyPowers61, 31);
+    buildPowers61(universalPowers61, 256);
+}
+
+//Arithmetic mod the Mersenne prime 2^61-1: 2^61 is 1, so reducing is a
+//shift and an add instead of a division
+static const unsigned long long P61 = (1ULL << 61) - 1;
+
+static inline unsigned long long reduce61(unsigned long long x){
+    x = (x & P61) + (x >> 61);
+    return x>=P61 ? x-P61 : x;
+}
+
+//a*b mod 2^61-1 for a, b below 2^61
+static inline unsigned long long mulMod61(unsigned long long a, unsigned long long b){
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 prod = (unsigned __int128)a * b;
+    unsigned long long lo = (unsigned long long)prod;
+    unsigned long long hi = (unsigned long long)(prod >> 64);
+#else
+    unsigned long long aLo = (unsigned int)a, aHi = a >> 32;
+    unsigned long long bLo = (unsigned int)b, bHi = b >> 32;
+    unsigned long long mid = aHi*bLo + aLo*bHi;  //Below 2^62
+    unsigned long long lo = aLo*bLo + (mid << 32);
+    unsigned long long hi = aHi*bHi + (mid >> 32) + (lo < (mid << 32));
+#endif
+    //2^64 is 8 mod 2^61-1
+    return reduce61((hi << 3) + (lo >> 61) + (lo & P61));
+}
+
+//Spreads a value below 2^61 over all 64 bits (Fibonacci hashing). The
+//multiplier is odd, so the low bits stay a bijection of the input's
+static inline unsigned long long spread61(unsigned long long x){
+    return x * 0x9E3779B97F4A7C15ULL;
+}
+
+//Final mixing step shared by bitwiseHash and bitwiseWideHash
+static unsigned long bitwiseFinish(unsigned long hash, int size){
     hash ^= hash >> 16;
     hash *= 0x7feb352d;
     hash ^= hash >> 15;
@@ -23,17 +64,47 @@ unsigned long HashFunctions::bitwiseHash(const string& url, int size){
     
     return hash % size;
 }
+//bitwiseFinish without the final %, in 64-bit arithmetic
+static unsigned long long bitwiseMix64(unsigned long long hash){
+    hash ^= hash >> 16;
+    hash *= 0x7feb352d;
+    hash ^= hash >> 15;
+    hash *= 0x846ca68b;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+//Uses bit-level operations for speed and good distribution
+unsigned long HashFunctions::bitwiseHash(const string& url, int size){
+    return bitwiseHash(url.data(), url.length(), size);
+}
+
+unsigned long HashFunctions::bitwiseHash(const char* key, size_t len, int size){
+    unsigned long hash = 0;
+    
+    //First pass: accumulate characters
+    for(size_t i = 0; i < len; i++){
+        hash = hash * 31 + (unsigned char)key[i];
+    }
+    
+    //Bitwise mixing for better distribution
+    return bitwiseFinish(hash, size);
+}
 
 //Polynomial Rolling Hash
 //Formula: h(s) = (s[0]*a^(n-1) + s[1]*a^(n-2) + ... + s[n-1]) mod m
 //Using a=31 (small prime) with Horner's rule
 unsigned long HashFunctions::polynomialHash(const string& url, int size){
+    return polynomialHash(url.data(), url.length(), size);
+}
+
+unsigned long HashFunctions::polynomialHash(const char* key, size_t len, int size){
     unsigned long hash = 0;
     const unsigned long prime = 31;
     
     //Use Horner's rule: h = (h * a + c) mod m
-    for(size_t i = 0; i < url.length(); i++){
-        hash = (hash * prime + (unsigned char)url[i]) % size;
+    for(size_t i = 0; i < len; i++){
+        hash = (hash * prime + (unsigned char)key[i]) % size;
     }
     
     return hash;
@@ -42,13 +113,324 @@ unsigned long HashFunctions::polynomialHash(const string& url, int size){
 // Universal hash function as specified in assignment
 // Formula: ha,b(x) = ((a * #(x) + b) mod k*Hsize) / k
 unsigned long HashFunctions::universalHash(const string& url, int size){
+    return universalHash(url.data(), url.length(), size);
+}
+
+unsigned long HashFunctions::universalHash(const char* key, size_t len, int size){
     unsigned long kHsize = k*size;
     unsigned long hashValue = 0;
     
     //Compute #(x) using Horner's rule with base 256
-    for(size_t i=0; i<url.length(); i++){
-        hashValue = (hashValue*256+(unsigned char)url[i])%kHsize;
+    for(size_t i=0; i<len; i++){
+        hashValue = (hashValue*256+(unsigned char)key[i])%kHsize;
+    }
+    
+    //Apply universal hash formula
+    hashValue = ((a*hashValue+b)%kHsize)/k;
+    return hashValue;
+}
+
+unsigned long long HashFunctions::bitwiseHash64(const char* key, size_t len){
+    unsigned long long hash = 0;
+    for(size_t i = 0; i < len; i++){
+        hash = hash * 31 + (unsigned char)key[i];
+    }
+    return bitwiseMix64(hash);
+}
+
+//Horner's rule mod 2^61-1: h = (h * 31 + c) mod p
+unsigned long long HashFunctions::polynomialHash64(const char* key, size_t len){
+    unsigned long long hash = 0;
+    for(size_t i = 0; i < len; i++){
+        hash = reduce61(mulMod61(hash, 31) + (unsigned char)key[i]);
+    }
+    return spread61(hash);
+}
+
+//(a * #(x) + b) mod p with p = 2^61-1, #(x) in base 256 mod p
+unsigned long long HashFunctions::universalHash64(const char* key, size_t len){
+    unsigned long long hashValue = 0;
+    for(size_t i = 0; i < len; i++){
+        //Multiplying by 2^8 mod 2^61-1 rotates the 61-bit value
+        hashValue = reduce61(((hashValue << 8) & P61) + (hashValue >> 53) + (unsigned char)key[i]);
+    }
+    return spread61(reduce61(mulMod61(a61, hashValue) + b61));
+}
+
+
+//Block kernels: sum of block[j]*pw[j] over one 32-byte block, mod 2^64.
+//Each product is independent, unlike the byte loops' serial chain
+static unsigned long long dotScalar(const unsigned char* block, const unsigned long long* pw){
+    unsigned long long s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for(int j=0; j<32; j+=4){
+        s0 += block[j]*pw[j];
+        s1 += block[j+1]*pw[j+1];
+        s2 += block[j+2]*pw[j+2];
+        s3 += block[j+3]*pw[j+3];
+    }
+    return s0+s1+s2+s3;
+}
+
+#ifdef HASH_X86_KERNELS
+//Bytes are widened to 64-bit lanes and multiplied with _mul_epu32, which
+//only sees the low 32 bits of a power; WIDE adds the high half for powers
+//taken mod 2^64
+template <bool WIDE>
+__attribute__((target("sse4.1")))
+static unsigned long long dotSse41(const unsigned char* block, const unsigned long long* pw){
+    __m128i acc = _mm_setzero_si128();
+    for(int j=0; j<32; j+=2){
+        unsigned short two;
+        memcpy(&two, block+j, 2);
+        __m128i c = _mm_cvtepu8_epi64(_mm_cvtsi32_si128(two));
+        __m128i p = _mm_loadu_si128((const __m128i*)(pw+j));
+        acc = _mm_add_epi64(acc, _mm_mul_epu32(c, p));
+        if(WIDE){
+            __m128i hi = _mm_mul_epu32(c, _mm_srli_epi64(p, 32));
+            acc = _mm_add_epi64(acc, _mm_slli_epi64(hi, 32));
+        }
+    }
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi64(acc, acc));
+    return (unsigned long long)_mm_cvtsi128_si64(acc);
+}
+
+template <bool WIDE>
+__attribute__((target("avx2")))
+static unsigned long long dotAvx2(const unsigned char* block, const unsigned long long* pw){
+    __m256i acc = _mm256_setzero_si256();
+    for(int j=0; j<32; j+=4){
+        int four;
+        memcpy(&four, block+j, 4);
+        __m256i c = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(four));
+        __m256i p = _mm256_loadu_si256((const __m256i*)(pw+j));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epu32(c, p));
+        if(WIDE){
+            __m256i hi = _mm256_mul_epu32(c, _mm256_srli_epi64(p, 32));
+            acc = _mm256_add_epi64(acc, _mm256_slli_epi64(hi, 32));
+        }
+    }
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+    return (unsigned long long)_mm_cvtsi128_si64(sum);
+}
+#endif
+
+static HashKernel bestKernel(){
+#ifdef HASH_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        return KERNEL_AVX2;
+    }
+    if(__builtin_cpu_supports("sse4.1")){
+        return KERNEL_SSE41;
+    }
+#endif
+    return KERNEL_SCALAR;
+}
+
+static HashKernel& activeKernel(){
+    static HashKernel kernel = bestKernel();
+    return kernel;
+}
+
+HashKernel HashFunctions::getKernel(){
+    return activeKernel();
+}
+
+bool HashFunctions::setKernel(HashKernel kernel){
+    if(!kernelSupported(kernel)){
+        return false;
+    }
+    activeKernel() = kernel;
+    return true;
+}
+
+bool HashFunctions::kernelSupported(HashKernel kernel){
+    if(kernel==KERNEL_SCALAR){
+        return true;
+    }
+#ifdef HASH_X86_KERNELS
+    __builtin_cpu_init();
+    if(kernel==KERNEL_SSE41){
+        return __builtin_cpu_supports("sse4.1");
+    }
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+const char* HashFunctions::kernelName(HashKernel kernel){
+    if(kernel==KERNEL_SSE41){
+        return "SSE4.1";
+    }
+    else if(kernel==KERNEL_AVX2){
+        return "AVX2";
+    }
+    return "Scalar";
+}
+
+//One block's dot product on the given kernel; wide means 64-bit powers
+static unsigned long long blockDot(HashKernel kernel, const unsigned char* block, const unsigned long long* pw, bool wide){
+#ifdef HASH_X86_KERNELS
+    if(kernel==KERNEL_AVX2){
+        return wide ? dotAvx2<true>(block, pw) : dotAvx2<false>(block, pw);
+    }
+    else if(kernel==KERNEL_SSE41){
+        return wide ? dotSse41<true>(block, pw) : dotSse41<false>(block, pw);
+    }
+#else
+    (void)kernel;
+    (void)wide;
+#endif
+    return dotScalar(block, pw);
+}
+
+void HashFunctions::buildPowers(PowerTable& t, unsigned long long base, unsigned long long modulus){
+    t.modulus = modulus;
+    unsigned long long power = modulus ? 1%modulus : 1;
+    for(int r=0; r<=32; r++){
+        t.pwRun[r] = power;
+        if(r<32){
+            t.pw[31-r] = power;
+        }
+        power = modulus ? (power*base)%modulus : power*base;
+    }
+}
+
+//Evaluates sum(key[i]*base^(len-1-i)) -- the recurrence h = h*base + c of
+//the byte loops -- one 32-byte block at a time. The last partial block is
+//zero-padded at the front so it reuses the same powers. Powers and running
+//values must stay below 2^32 when a modulus is set
+unsigned long long HashFunctions::blockRecurrence(const char* key, size_t len, const PowerTable& t){
+    HashKernel kernel = activeKernel();
+    bool wide = t.modulus==0;
+    unsigned long long hash = 0;
+    unsigned char padded[32];
+    
+    for(size_t pos=0; pos<len; pos+=32){
+        size_t n = len-pos<32 ? len-pos : 32;
+        const unsigned char* block = (const unsigned char*)key+pos;
+        
+        //Without a modulus the plain recurrence is cheaper than a padded
+        //scalar block
+        if(n<32 && wide && kernel==KERNEL_SCALAR){
+            for(size_t i=0; i<n; i++){
+                hash = hash*t.pwRun[1] + block[i];
+            }
+            break;
+        }
+        
+        if(n<32){
+            memset(padded, 0, 32-n);
+            memcpy(padded+32-n, block, n);
+            block = padded;
+        }
+        
+        unsigned long long dot = blockDot(kernel, block, t.pw, wide);
+        
+        if(wide){
+            hash = hash*t.pwRun[n] + dot;
+        }
+        else{
+            hash = ((hash*t.pwRun[n])%t.modulus + dot%t.modulus)%t.modulus;
+        }
+    }
+    
+    return hash;
+}
+
+void HashFunctions::buildPowers61(MersennePowers& t, unsigned long long base){
+    unsigned long long power = 1;
+    for(int r=0; r<=32; r++){
+        t.pwRun[r] = power;
+        if(r<32){
+            t.pwLo[31-r] = power & 0xFFFFFFFFULL;
+            t.pwHi[31-r] = power >> 32;
+        }
+        power = mulMod61(power, base);
+    }
+}
+
+//blockRecurrence mod 2^61-1. Each block is two 32-bit-power dot products,
+//sum(c*lo) below 2^45 and sum(c*hi) below 2^42, recombined as lo + hi*2^32
+unsigned long long HashFunctions::blockRecurrence61(const char* key, size_t len, const MersennePowers& t){
+    HashKernel kernel = activeKernel();
+    unsigned long long hash = 0;
+    unsigned char padded[32];
+    
+    for(size_t pos=0; pos<len; pos+=32){
+        size_t n = len-pos<32 ? len-pos : 32;
+        const unsigned char* block = (const unsigned char*)key+pos;
+        
+        if(n<32){
+            memset(padded, 0, 32-n);
+            memcpy(padded+32-n, block, n);
+            block = padded;
+        }
+        
+        unsigned long long dotLo = blockDot(kernel, block, t.pwLo, false);
+        unsigned long long dotHi = blockDot(kernel, block, t.pwHi, false);
+        
+        //hi*2^32 = (hi>>29)*2^61 + (hi&(2^29-1))*2^32, and 2^61 is 1
+        unsigned long long blockValue = reduce61(reduce61(dotLo) + (dotHi >> 29) + ((dotHi & 0x1FFFFFFFULL) << 32));
+        hash = reduce61(mulMod61(hash, t.pwRun[n]) + blockValue);
+    }
+    
+    return hash;
+}
+
+unsigned long long HashFunctions::bitwiseWideHash64(const char* key, size_t len){
+    return bitwiseMix64(blockRecurrence(key, len, bitwisePowers));
+}
+
+unsigned long long HashFunctions::polynomialWideHash64(const char* key, size_t len){
+    return spread61(blockRecurrence61(key, len, polyPowers61));
+}
+
+unsigned long long HashFunctions::universalWideHash64(const char* key, size_t len){
+    unsigned long long hashValue = blockRecurrence61(key, len, universalPowers61);
+    return spread61(reduce61(mulMod61(a61, hashValue) + b61));
+}
+
+unsigned long HashFunctions::bitwiseWideHash(const string& url, int size){
+    return bitwiseWideHash(url.data(), url.length(), size);
+}
+
+unsigned long HashFunctions::bitwiseWideHash(const char* key, size_t len, int size){
+    //Truncating the mod 2^64 sum matches the byte loop when unsigned long
+    //is 32 bits wide
+    unsigned long hash = (unsigned long)blockRecurrence(key, len, bitwisePowers);
+    return bitwiseFinish(hash, size);
+}
+
+unsigned long HashFunctions::polynomialWideHash(const string& url, int size){
+    return polynomialWideHash(url.data(), url.length(), size);
+}
+
+unsigned long HashFunctions::polynomialWideHash(const char* key, size_t len, int size){
+    if(polyPowers.modulus!=(unsigned long long)size){
+        buildPowers(polyPowers, 31, size);
+    }
+    return (unsigned long)blockRecurrence(key, len, polyPowers);
+}
+
+unsigned long HashFunctions::universalWideHash(const string& url, int size){
+    return universalWideHash(url.data(), url.length(), size);
+}
+
+unsigned long HashFunctions::universalWideHash(const char* key, size_t len, int size){
+    unsigned long kHsize = k*size;
+    
+    //Block powers must fit the kernels' 32-bit multiplies
+    if(kHsize>0xFFFFFFFFul){
+        return universalHash(key, len, size);
+    }
+    
+    if(universalPowers.modulus!=kHsize){
+        buildPowers(universalPowers, 256, kHsize);
     }
+    unsigned long hashValue = (unsigned long)blockRecurrence(key, len, universalPowers);
     
     //Apply universal hash formula
     hashValue = ((a*hashValue+b)%kHsize)/k;
@@ -0,0 +1,337 @@
+#include "../include/HashQuality.h"
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include "../include/HashPolicies.h"
+
+//Input bytes are bucketed by distance from the key's end, where the
+//multiply-and-add hashes mix least; bytes further back share the last row
+static const int AVALANCHE_BYTES = 64;
+static const int MAX_OUTPUT_BITS = 31;
+
+//Runs work(first, last, worker) over [0, count), one contiguous range per thread
+template <typename Work>
+static void parallelRanges(long long count, int threads, Work work){
+    if(threads>count){
+        threads = count>0 ? (int)count : 1;
+    }
+    if(threads<=1){
+        work(0LL, count, 0);
+        return;
+    }
+    vector<thread> workers;
+    for(int t=0; t<threads; t++){
+        workers.push_back(thread(work, count*t/threads, count*(t+1)/threads, t));
+    }
+    for(size_t t=0; t<workers.size(); t++){
+        workers[t].join();
+    }
+}
+
+//Values in [0, n) with bit j set
+static long long countBit(long long n, int j){
+    long long low = n & ((2LL << j)-1);
+    return ((n >> (j+1)) << j) + (low>(1LL << j) ? low-(1LL << j) : 0);
+}
+
+//Values in [0, n) with bits j and k set, j < k
+static long long countBoth(long long n, int j, int k){
+    long long both = (n >> (k+1)) << (k-1);
+    long long rest = n & ((2LL << k)-1);
+    if(rest>(1LL << k)){
+        both += countBit(rest, j)-countBit(1LL << k, j);
+    }
+    return both;
+}
+
+static double correlation(double pBoth, double p1, double p2){
+    double spread = p1*(1-p1)*p2*(1-p2);
+    return spread>0 ? (pBoth-p1*p2)/sqrt(spread) : 0;
+}
+
+HashQualityAnalyzer::HashQualityAnalyzer(const vector<string>& corpus, int numThreads) : keys(corpus){
+    threads = numThreads<1 ? 1 : numThreads;
+    loadFactor = 0.5;
+    avalancheKeys = 1000;
+}
+
+void HashQualityAnalyzer::setLoadFactor(double load){
+    loadFactor = load;
+}
+
+void HashQualityAnalyzer::setAvalancheKeys(int count){
+    avalancheKeys = count<0 ? 0 : count;
+}
+
+int HashQualityAnalyzer::slot(HashFunctions& f, const QualityTarget& target, const SlotReducer& reducer,
+                              const char* key, size_t len){
+    if(target.sized){
+        int size = reducer.getSize();
+        switch(target.algorithm->type){
+            case POLYNOMIAL_HASH: return (int)f.polynomialHash(key, len, size);
+            case UNIVERSAL_HASH: return (int)f.universalHash(key, len, size);
+            default: return (int)f.bitwiseHash(key, len, size);
+        }
+    }
+    return reducer.reduce(target.algorithm->hash64(f, key, len));
+}
+
+void HashQualityAnalyzer::computeSlots(const QualityTarget& target, int tableSize, vector<int>& slots) const{
+    slots.resize(keys.size());
+    SlotReducer reducer(tableSize, REDUCE_MOD);
+    parallelRanges((long long)keys.size(), threads, [&](long long first, long long last, int){
+        HashFunctions f;
+        for(long long i=first; i<last; i++){
+            slots[i] = slot(f, target, reducer, keys[i].data(), keys[i].size());
+        }
+    });
+}
+
+DistributionResult HashQualityAnalyzer::distribution(const vector<int>& slots, int tableSize) const{
+    vector<int> counts(tableSize, 0);
+    for(size_t i=0; i<slots.size(); i++){
+        counts[slots[i]]++;
+    }
+    
+    DistributionResult result;
+    double n = (double)slots.size();
+    double expected = n/tableSize;
+    double sumSquares = 0;
+    int empty = 0;
+    result.maxBucket = 0;
+    for(int b=0; b<tableSize; b++){
+        sumSquares += (double)counts[b]*counts[b];
+        if(counts[b]==0) empty++;
+        if(counts[b]>result.maxBucket) result.maxBucket = counts[b];
+    }
+    
+    //sum (c-E)^2/E = sum c^2/E - n
+    double degrees = tableSize-1;
+    result.chiSquared = expected>0 ? sumSquares/expected-n : 0;
+    result.zScore = (result.chiSquared-degrees)/sqrt(2*degrees);
+    result.emptyFraction = (double)empty/tableSize;
+    result.expectedEmpty = exp(n*log1p(-1.0/tableSize));
+    return result;
+}
+
+AvalancheResult HashQualityAnalyzer::avalanche(const QualityTarget& target, int tableSize) const{
+    AvalancheResult result;
+    result.outputBits = 1;
+    while(result.outputBits<MAX_OUTPUT_BITS && (1LL << result.outputBits)<tableSize){
+        result.outputBits++;
+    }
+    const int bits = result.outputBits;
+    
+    //Per-thread tallies: flips[row][bit], per-bit and per-pair flip counts
+    struct Tally {
+        long long trials[AVALANCHE_BYTES*8];
+        long long flips[AVALANCHE_BYTES*8][MAX_OUTPUT_BITS];
+        long long single[MAX_OUTPUT_BITS];
+        long long pair[MAX_OUTPUT_BITS][MAX_OUTPUT_BITS];
+        long long total;
+        long long changed;
+    };
+    long long sample = avalancheKeys<(long long)keys.size() ? avalancheKeys : (long long)keys.size();
+    int workers = threads<sample ? threads : (sample>0 ? (int)sample : 1);
+    vector<Tally> tallies(workers);
+    for(int t=0; t<workers; t++){
+        memset(&tallies[t], 0, sizeof(Tally));
+    }
+    
+    SlotReducer reducer(tableSize, REDUCE_MOD);
+    parallelRanges(sample, workers, [&](long long first, long long last, int worker){
+        HashFunctions f;
+        Tally& tally = tallies[worker];
+        string key;
+        for(long long s=first; s<last; s++){
+            key = keys[s*(long long)keys.size()/sample];
+            int base = slot(f, target, reducer, key.data(), key.size());
+            for(size_t p=0; p<key.size(); p++){
+                size_t fromEnd = key.size()-1-p;
+                int row = (int)(fromEnd<(size_t)AVALANCHE_BYTES ? fromEnd : AVALANCHE_BYTES-1)*8;
+                for(int q=0; q<8; q++){
+                    key[p] ^= (char)(1 << q);
+                    unsigned int diff = (unsigned int)(base ^ slot(f, target, reducer, key.data(), key.size()));
+                    key[p] ^= (char)(1 << q);
+                    
+                    tally.trials[row+q]++;
+                    tally.total++;
+                    for(int j=0; j<bits; j++){
+                        if(!(diff >> j & 1)) continue;
+                        tally.changed++;
+                        tally.single[j]++;
+                        tally.flips[row+q][j]++;
+                        for(int k=j+1; k<bits; k++){
+                            if(diff >> k & 1) tally.pair[j][k]++;
+                        }
+                    }
+                }
+            }
+        }
+    });
+    for(int t=1; t<workers; t++){
+        long long* into = (long long*)&tallies[0];
+        const long long* from = (const long long*)&tallies[t];
+        for(size_t i=0; i<sizeof(Tally)/sizeof(long long); i++){
+            into[i] += from[i];
+        }
+    }
+    const Tally& all = tallies[0];
+    
+    //A random function's slots for the original and flipped key are two
+    //independent uniform draws from [0, m): bit j differs with 2p(1-p)
+    vector<double> ones(bits), ideal(bits);
+    double idealChanged = 0;
+    for(int j=0; j<bits; j++){
+        ones[j] = (double)countBit(tableSize, j)/tableSize;
+        ideal[j] = 2*ones[j]*(1-ones[j]);
+        idealChanged += ideal[j];
+    }
+    
+    result.flips = all.total;
+    result.changedRatio = all.total>0 ? all.changed/(all.total*idealChanged) : 0;
+    result.worstBias = 0;
+    result.worstByte = 0;
+    //Only bytes most sampled keys reach, so sampling noise stays well below
+    //the biases worth reporting
+    long long minTrials = sample/2>100 ? sample/2 : 100;
+    for(int row=0; row<AVALANCHE_BYTES*8; row++){
+        if(all.trials[row]<minTrials) continue;
+        for(int j=0; j<bits; j++){
+            double bias = fabs((double)all.flips[row][j]/all.trials[row]-ideal[j]);
+            if(bias>result.worstBias){
+                result.worstBias = bias;
+                result.worstByte = row/8;
+            }
+        }
+    }
+    
+    //Bit independence: flips of two output bits should be as correlated as
+    //a random function's, which is only zero for power-of-two sizes
+    result.worstBIC = 0;
+    for(int j=0; j<bits && all.total>0; j++){
+        for(int k=j+1; k<bits; k++){
+            double p11 = (double)countBoth(tableSize, j, k)/tableSize;
+            double p10 = ones[j]-p11;
+            double p01 = ones[k]-p11;
+            double p00 = 1-ones[j]-ones[k]+p11;
+            double expected = correlation(2*(p00*p11+p01*p10), ideal[j], ideal[k]);
+            double observed = correlation((double)all.pair[j][k]/all.total, (double)all.single[j]/all.total,
+                                          (double)all.single[k]/all.total);
+            if(fabs(observed-expected)>result.worstBIC){
+                result.worstBIC = fabs(observed-expected);
+            }
+        }
+    }
+    return result;
+}
+
+template <typename ProbePolicy>
+ProbeResult HashQualityAnalyzer::probes(const vector<int>& slots, int tableSize) const{
+    long long inserts = (long long)(loadFactor*tableSize);
+    if(inserts>(long long)slots.size()/2){
+        inserts = slots.size()/2;
+    }
+    
+    ProbeResult result;
+    result.failed = 0;
+    result.maxProbes = 0;
+    vector<char> used(tableSize, 0);
+    double hitProbes = 0;
+    for(long long i=0; i<inserts; i++){
+        int idx = slots[i];
+        int probes = 1;
+        while(used[idx] && probes<tableSize){
+            idx = ProbePolicy::next(idx, probes, tableSize);
+            probes++;
+        }
+        if(used[idx]){
+            result.failed++;
+            continue;
+        }
+        used[idx] = 1;
+        hitProbes += probes;
+        if(probes>result.maxProbes) result.maxProbes = probes;
+    }
+    
+    //Misses: the next keys of the corpus, walked until an empty slot
+    double missProbes = 0;
+    for(long long i=inserts; i<2*inserts; i++){
+        int idx = slots[i];
+        int probes = 1;
+        while(used[idx] && probes<tableSize){
+            idx = ProbePolicy::next(idx, probes, tableSize);
+            probes++;
+        }
+        missProbes += probes;
+    }
+    
+    long long stored = inserts-result.failed;
+    double a = (double)stored/tableSize;
+    result.load = a;
+    result.observedHit = stored>0 ? hitProbes/stored : 0;
+    result.observedMiss = inserts>0 ? missProbes/inserts : 0;
+    if(ProbePolicy::type==QUADRATIC_PROBING){
+        result.expectedHit = 1-log(1-a)-a/2;
+        result.expectedMiss = 1/(1-a)-a-log(1-a);
+    }
+    else{
+        result.expectedHit = 0.5*(1+1/(1-a));
+        result.expectedMiss = 0.5*(1+1/((1-a)*(1-a)));
+    }
+    return result;
+}
+
+QualityReport HashQualityAnalyzer::analyze(const QualityTarget& target, int tableSize) const{
+    QualityReport report;
+    report.target = target;
+    report.tableSize = tableSize;
+    report.keys = keys.size();
+    
+    vector<int> slots;
+    computeSlots(target, tableSize, slots);
+    report.distribution = distribution(slots, tableSize);
+    report.avalanche = avalanche(target, tableSize);
+    report.linear = probes<LinearProbePolicy>(slots, tableSize);
+    report.quadratic = probes<QuadraticProbePolicy>(slots, tableSize);
+    return report;
+}
+
+vector<QualityTarget> HashQualityAnalyzer::allTargets(){
+    vector<QualityTarget> targets;
+    for(int i=0; i<HashRegistry::count(); i++){
+        const HashAlgorithm& algorithm = HashRegistry::get(i);
+        HashType type = algorithm.type;
+        if(type==BITWISE_WIDE_HASH || type==POLYNOMIAL_WIDE_HASH || type==UNIVERSAL_WIDE_HASH){
+            continue;
+        }
+        QualityTarget target = {&algorithm, false};
+        if(type==BITWISE_HASH || type==POLYNOMIAL_HASH || type==UNIVERSAL_HASH){
+            target.sized = true;
+            targets.push_back(target);
+            target.sized = false;
+        }
+        targets.push_back(target);
+    }
+    return targets;
+}
+
+const char* HashQualityAnalyzer::formName(const QualityTarget& target){
+    return target.sized ? "sized" : "hash64";
+}
+
+bool HashQualityAnalyzer::isPrime(int n){
+    if(n<2) return false;
+    if(n%2==0) return n==2;
+    for(int d=3; (long long)d*d<=n; d+=2){
+        if(n%d==0) return false;
+    }
+    return true;
+}
+
+int HashQualityAnalyzer::previousPrime(int n){
+    for(int p=n-1; p>=2; p--){
+        if(isPrime(p)) return p;
+    }
+    return 2;
+}
@@ -0,0 +1,49 @@
+#include "../include/HashRegistry.h"
+#include "../include/HashPolicies.h"
+#include "../include/FastHashes.h"
+
+//Registry entries call straight into the compile-time policies
+template <typename HashPolicy>
+static unsigned long long policyHash(HashFunctions& f, const char* key, size_t len){
+    return HashPolicy::hash64(f, key, len);
+}
+
+static const char* wideKernel(){
+    return HashFunctions::kernelName(HashFunctions::getKernel());
+}
+
+static const char* crc32cPath(){
+    return FastHashes::crc32cHardwareEnabled() ? "SSE4.2" : "software";
+}
+
+static const HashAlgorithm ALGORITHMS[] = {
+    {BITWISE_HASH, BitwiseHashPolicy::name(), "Bitwise", policyHash<BitwiseHashPolicy>, 0},
+    {POLYNOMIAL_HASH, PolynomialHashPolicy::name(), "Polynomial", policyHash<PolynomialHashPolicy>, 0},
+    {UNIVERSAL_HASH, UniversalHashPolicy::name(), "Universal", policyHash<UniversalHashPolicy>, 0},
+    {BITWISE_WIDE_HASH, BitwiseWideHashPolicy::name(), "BitwiseWide", policyHash<BitwiseWideHashPolicy>, wideKernel},
+    {POLYNOMIAL_WIDE_HASH, PolynomialWideHashPolicy::name(), "PolynomialWide", policyHash<PolynomialWideHashPolicy>, wideKernel},
+    {UNIVERSAL_WIDE_HASH, UniversalWideHashPolicy::name(), "UniversalWide", policyHash<UniversalWideHashPolicy>, wideKernel},
+    {XXHASH64_HASH, XXHash64HashPolicy::name(), "XXHash64", policyHash<XXHash64HashPolicy>, 0},
+    {WYHASH_HASH, WyhashHashPolicy::name(), "Wyhash", policyHash<WyhashHashPolicy>, 0},
+    {FNV1A_HASH, Fnv1aHashPolicy::name(), "FNV1a", policyHash<Fnv1aHashPolicy>, 0},
+    {MURMUR3_HASH, Murmur3HashPolicy::name(), "Murmur3", policyHash<Murmur3HashPolicy>, 0},
+    {CRC32C_HASH, Crc32cHashPolicy::name(), "CRC32C", policyHash<Crc32cHashPolicy>, crc32cPath}
+};
+
+int HashRegistry::count(){
+    return sizeof(ALGORITHMS)/sizeof(ALGORITHMS[0]);
+}
+
+const HashAlgorithm& HashRegistry::get(int index){
+    return ALGORITHMS[index];
+}
+
+//Unknown types fall back to the first entry, like the engines' else branches
+const HashAlgorithm& HashRegistry::find(HashType type){
+    for(int i=0; i<count(); i++){
+        if(ALGORITHMS[i].type==type){
+            return ALGORITHMS[i];
+        }
+    }
+    return ALGORITHMS[0];
+}
@@ -0,0 +1,51 @@
+#include "../include/KeyArena.h"
+
+KeyArena::KeyArena(){
+    deadBytes = 0;
+}
+
+//Copies the key to the end of the buffer and returns its offset
+size_t KeyArena::append(const char* key, size_t len){
+    size_t offset = bytes.size();
+    bytes.insert(bytes.end(), key, key+len);
+    return offset;
+}
+
+size_t KeyArena::append(const string& key){
+    return append(key.data(), key.size());
+}
+
+//Marks len bytes as belonging to a deleted key
+void KeyArena::release(unsigned int len){
+    deadBytes += len;
+}
+
+string KeyArena::get(size_t offset, unsigned int len) const{
+    return string(bytes.data()+offset, len);
+}
+
+void KeyArena::reserve(size_t len){
+    bytes.reserve(len);
+}
+
+void KeyArena::swap(KeyArena& other){
+    bytes.swap(other.bytes);
+    std::swap(deadBytes, other.deadBytes);
+}
+
+void KeyArena::clear(){
+    vector<char>().swap(bytes);
+    deadBytes = 0;
+}
+
+size_t KeyArena::size() const{
+    return bytes.size();
+}
+
+size_t KeyArena::capacity() const{
+    return bytes.capacity();
+}
+
+size_t KeyArena::getDeadBytes() const{
+    return deadBytes;
+}
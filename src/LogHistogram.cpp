@@ -0,0 +1,106 @@
+#include "../include/LogHistogram.h"
+#include <cmath>
+
+const int LogHistogram::SUB_BITS;
+const int LogHistogram::SUB_BUCKETS;
+
+//Index of the highest set bit of a non-zero value
+static int highestBit(unsigned long long value){
+#if defined(__GNUC__)
+    return 63-__builtin_clzll(value);
+#else
+    int bit = 0;
+    while(value >>= 1){
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+//Values below SUB_BUCKETS map to themselves. A larger value with highest
+//bit m keeps its top SUB_BITS+1 bits, which land in [SUB_BUCKETS,
+//2*SUB_BUCKETS), after (m-SUB_BITS) rows of SUB_BUCKETS buckets
+int LogHistogram::bucketOf(unsigned long long value){
+    if(value<(unsigned long long)SUB_BUCKETS){
+        return (int)value;
+    }
+    int shift = highestBit(value)-SUB_BITS;
+    return shift*SUB_BUCKETS + (int)(value >> shift);
+}
+
+//Largest value that falls in bucket
+unsigned long long LogHistogram::bucketHigh(int bucket){
+    if(bucket<SUB_BUCKETS){
+        return bucket;
+    }
+    int shift = bucket/SUB_BUCKETS-1;
+    unsigned long long top = bucket-shift*SUB_BUCKETS;
+    return ((top+1) << shift)-1;
+}
+
+LogHistogram::LogHistogram(){
+    total = 0;
+    maxValue = 0;
+}
+
+void LogHistogram::record(unsigned long long value){
+    int bucket = bucketOf(value);
+    if(bucket>=(int)counts.size()){
+        counts.resize(bucket+1, 0);
+    }
+    counts[bucket]++;
+    total++;
+    
+    if(value>maxValue){
+        maxValue = value;
+    }
+}
+
+void LogHistogram::merge(const LogHistogram& other){
+    if(other.counts.size()>counts.size()){
+        counts.resize(other.counts.size(), 0);
+    }
+    for(size_t i=0; i<other.counts.size(); i++){
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    
+    if(other.maxValue>maxValue){
+        maxValue = other.maxValue;
+    }
+}
+
+void LogHistogram::reset(){
+    counts.clear();
+    total = 0;
+    maxValue = 0;
+}
+
+unsigned long long LogHistogram::getCount() const{
+    return total;
+}
+
+unsigned long long LogHistogram::getMax() const{
+    return maxValue;
+}
+
+unsigned long long LogHistogram::percentile(double p) const{
+    if(total==0){
+        return 0;
+    }
+    
+    unsigned long long rank = (unsigned long long)ceil(p/100.0*total);
+    if(rank<1){
+        rank = 1;
+    }
+    
+    unsigned long long seen = 0;
+    for(size_t i=0; i<counts.size(); i++){
+        seen += counts[i];
+        if(seen>=rank){
+            unsigned long long high = bucketHigh((int)i);
+            return high<maxValue ? high : maxValue;
+        }
+    }
+    return maxValue;
+}
@@ -0,0 +1,270 @@
+#include "../include/MappedURLFile.h"
+#include "../include/URLKeyCodec.h"
+#include <thread>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define MAPPED_URL_FILE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+const size_t MappedURLFile::MIN_CHUNK_BYTES;
+
+static bool isTrimmed(char c){
+    return c==' ' || c=='\t' || c=='\r' || c=='\n';
+}
+
+static bool isSpace(char c){
+    return c==' ' || c=='\t' || c=='\n' || c=='\v' || c=='\f' || c=='\r';
+}
+
+//Leading integer of the first line, read like `stream >> int`: leading
+//whitespace skipped, optional sign, clamped to int; 0 if there is none
+int MappedURLFile::parseTableSize(const char* p, const char* end){
+    while(p<end && *p!='\n' && isSpace(*p)){
+        p++;
+    }
+    bool negative = false;
+    if(p<end && (*p=='+' || *p=='-')){
+        negative = *p=='-';
+        p++;
+    }
+    
+    long long value = 0;
+    bool digits = false;
+    while(p<end && *p>='0' && *p<='9'){
+        digits = true;
+        if(value<=INT_MAX){
+            value = value*10 + (*p-'0');
+        }
+        p++;
+    }
+    if(!digits){
+        return 0;
+    }
+    if(negative){
+        return value>(long long)INT_MAX+1 ? INT_MIN : (int)-value;
+    }
+    return value>INT_MAX ? INT_MAX : (int)value;
+}
+
+MappedURLFile::MappedURLFile(){
+    base = 0;
+    length = 0;
+    mapped = false;
+#if defined(_WIN32)
+    fileHandle = 0;
+    mappingHandle = 0;
+#endif
+    tableSize = 0;
+}
+
+MappedURLFile::~MappedURLFile(){
+    close();
+}
+
+void MappedURLFile::close(){
+    urls.clear();
+    tableSize = 0;
+    if(!base){
+        return;
+    }
+    
+    if(!mapped){
+        delete[] base;
+    }
+#if defined(_WIN32)
+    else{
+        UnmapViewOfFile(base);
+        CloseHandle((HANDLE)mappingHandle);
+        CloseHandle((HANDLE)fileHandle);
+    }
+#elif defined(MAPPED_URL_FILE_MMAP)
+    else{
+        munmap((void*)base, length);
+    }
+#endif
+    base = 0;
+    length = 0;
+    mapped = false;
+}
+
+//Splits [begin, end) into lines and each line at commas, keeping the
+//trimmed tokens with a known scheme
+void MappedURLFile::parseLines(const char* begin, const char* end, vector<URLView>& out){
+    const char* p = begin;
+    while(p<end){
+        const char* lineEnd = (const char*)memchr(p, '\n', end-p);
+        if(!lineEnd){
+            lineEnd = end;
+        }
+        
+        while(p<lineEnd){
+            const char* comma = (const char*)memchr(p, ',', lineEnd-p);
+            const char* tokenEnd = comma ? comma : lineEnd;
+            
+            const char* first = p;
+            const char* last = tokenEnd;
+            while(first<last && isTrimmed(*first)){
+                first++;
+            }
+            while(last>first && isTrimmed(last[-1])){
+                last--;
+            }
+            
+            if(first<last && URLKeyCodec::hasKnownScheme(first, last-first)){
+                URLView url;
+                url.data = first;
+                url.len = last-first;
+                out.push_back(url);
+            }
+            p = comma ? comma+1 : lineEnd;
+        }
+        p = lineEnd+1;
+    }
+}
+
+bool MappedURLFile::open(const string& filename, int threads){
+    close();
+    
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if(file==INVALID_HANDLE_VALUE){
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize)){
+        CloseHandle(file);
+        return false;
+    }
+    if(fileSize.QuadPart==0){
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    const char* view = mapping ? (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+    if(!view){
+        if(mapping){
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    base = view;
+    length = (size_t)fileSize.QuadPart;
+    mapped = true;
+    fileHandle = file;
+    mappingHandle = mapping;
+#elif defined(MAPPED_URL_FILE_MMAP)
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd<0){
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info)!=0){
+        ::close(fd);
+        return false;
+    }
+    if(info.st_size==0){
+        ::close(fd);
+        return true;
+    }
+    void* view = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  //The mapping keeps the file open
+    if(view==MAP_FAILED){
+        return false;
+    }
+    madvise(view, (size_t)info.st_size, MADV_SEQUENTIAL);
+    base = (const char*)view;
+    length = (size_t)info.st_size;
+    mapped = true;
+#else
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file){
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if(fileSize<=0){
+        fclose(file);
+        return fileSize==0;
+    }
+    char* buffer = new char[fileSize];
+    size_t got = fread(buffer, 1, fileSize, file);
+    fclose(file);
+    base = buffer;
+    length = got;
+    mapped = false;
+#endif
+    
+    const char* end = base+length;
+    const char* firstLineEnd = (const char*)memchr(base, '\n', length);
+    const char* body = firstLineEnd ? firstLineEnd+1 : end;
+    tableSize = parseTableSize(base, body);
+    
+    //Chunks end just after a newline so no line is split between threads
+    size_t bodyBytes = end-body;
+    size_t numChunks = threads>1 ? (size_t)threads : 1;
+    if(numChunks>bodyBytes/MIN_CHUNK_BYTES){
+        numChunks = bodyBytes/MIN_CHUNK_BYTES>0 ? bodyBytes/MIN_CHUNK_BYTES : 1;
+    }
+    
+    vector<const char*> bounds(1, body);
+    for(size_t i=1; i<numChunks; i++){
+        const char* cut = body + bodyBytes/numChunks*i;
+        if(cut<bounds.back()){
+            cut = bounds.back();
+        }
+        const char* newline = (const char*)memchr(cut, '\n', end-cut);
+        bounds.push_back(newline ? newline+1 : end);
+    }
+    bounds.push_back(end);
+    
+    if(numChunks==1){
+        parseLines(body, end, urls);
+        return true;
+    }
+    
+    vector<vector<URLView> > parts(numChunks);
+    vector<thread> workers;
+    for(size_t i=0; i<numChunks; i++){
+        workers.push_back(thread(parseLines, bounds[i], bounds[i+1], ref(parts[i])));
+    }
+    
+    size_t total = 0;
+    for(size_t i=0; i<numChunks; i++){
+        workers[i].join();
+        total += parts[i].size();
+    }
+    urls.reserve(total);
+    for(size_t i=0; i<numChunks; i++){
+        urls.insert(urls.end(), parts[i].begin(), parts[i].end());
+    }
+    return true;
+}
+
+int MappedURLFile::getTableSize() const{
+    return tableSize;
+}
+
+const vector<URLView>& MappedURLFile::getURLs() const{
+    return urls;
+}
+
+size_t MappedURLFile::getFileBytes() const{
+    return length;
+}
+
+bool MappedURLFile::isMapped() const{
+    return mapped;
+}
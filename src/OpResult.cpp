@@ -0,0 +1,3 @@
+#include "../include/OpResult.h"
+
+OpResult::OpResult() : success(false), slot(-1), probes(0), elapsed(0.0) {}
@@ -0,0 +1,122 @@
+#include "../include/OpTimer.h"
+#include <vector>
+#include <algorithm>
+
+#if defined(OP_TIMER_TSC) && defined(__GNUC__)
+#include <cpuid.h>
+#endif
+
+//Pairs of back-to-back reads used to estimate the cost of a reading
+static const int OVERHEAD_SAMPLES = 1001;
+
+//Busy-wait over which the TSC is compared with steady_clock
+static const chrono::milliseconds TSC_CALIBRATION(20);
+
+struct TimerCalibration {
+    double secondsPerTick;
+    double overheadTicks;
+};
+
+static unsigned long long readSteady(){
+    return chrono::steady_clock::now().time_since_epoch().count();
+}
+
+//Median cost of one interval with nothing inside it
+static double medianOverhead(unsigned long long (*read)()){
+    vector<unsigned long long> ticks(OVERHEAD_SAMPLES);
+    for(int i=0; i<OVERHEAD_SAMPLES; i++){
+        unsigned long long start = read();
+        ticks[i] = read()-start;
+    }
+    nth_element(ticks.begin(), ticks.begin()+OVERHEAD_SAMPLES/2, ticks.end());
+    return (double)ticks[OVERHEAD_SAMPLES/2];
+}
+
+static TimerCalibration calibrateSteady(){
+    TimerCalibration calibration;
+    calibration.secondsPerTick = (double)chrono::steady_clock::period::num/chrono::steady_clock::period::den;
+    calibration.overheadTicks = medianOverhead(readSteady);
+    return calibration;
+}
+
+static TimerCalibration calibrateTSC(){
+    TimerCalibration calibration;
+    calibration.secondsPerTick = 0;
+    calibration.overheadTicks = 0;
+#ifdef OP_TIMER_TSC
+    chrono::steady_clock::time_point wallStart = chrono::steady_clock::now();
+    unsigned long long tscStart = OpTimer::readTSC();
+    chrono::steady_clock::time_point wallEnd = wallStart;
+    while(wallEnd-wallStart<TSC_CALIBRATION){
+        wallEnd = chrono::steady_clock::now();
+    }
+    unsigned long long tscEnd = OpTimer::readTSC();
+    calibration.secondsPerTick = chrono::duration<double>(wallEnd-wallStart).count()/(double)(tscEnd-tscStart);
+    calibration.overheadTicks = medianOverhead(OpTimer::readTSC);
+#endif
+    return calibration;
+}
+
+//Measured once per process and source
+static const TimerCalibration& calibration(TimerSource timer){
+    static TimerCalibration steady = calibrateSteady();
+    if(timer==TIMER_TSC){
+        static TimerCalibration tsc = calibrateTSC();
+        return tsc;
+    }
+    return steady;
+}
+
+OpTimer::OpTimer(){
+    sampleEvery = 1;
+    countdown = 1;
+    setSource(TIMER_STEADY);
+}
+
+bool OpTimer::setSource(TimerSource timer){
+    if(timer==TIMER_TSC && !tscSupported()){
+        return false;
+    }
+    
+    source = timer;
+    secondsPerTick = calibration(timer).secondsPerTick;
+    overheadTicks = calibration(timer).overheadTicks;
+    return true;
+}
+
+//Every-th single operation is timed (1: all, 0: none). The count restarts
+//so the next operation is the first one timed
+void OpTimer::setSampleInterval(int every){
+    sampleEvery = every>0 ? every : 0;
+    countdown = 1;
+}
+
+//An invariant TSC ticks at a constant rate in every power state, so ticks
+//convert to seconds with a single factor
+bool OpTimer::tscSupported(){
+#if defined(OP_TIMER_TSC) && defined(__GNUC__)
+    unsigned int eax, ebx, ecx, edx;
+    if(!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax<0x80000007){
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8))!=0;
+#elif defined(OP_TIMER_TSC)
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if((unsigned int)regs[0]<0x80000007){
+        return false;
+    }
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8))!=0;
+#else
+    return false;
+#endif
+}
+
+const char* OpTimer::sourceName(TimerSource timer){
+    if(timer==TIMER_TSC){
+        return "TSC (calibrated against steady_clock)";
+    }
+    return "steady_clock";
+}
@@ -0,0 +1,199 @@
+#include "../include/OpTrace.h"
+#include <chrono>
+#include <cstring>
+
+static const char TRACE_MAGIC[8] = {'U', 'R', 'L', 'T', 'R', 'A', 'C', 'E'};
+static const unsigned char TRACE_VERSION = 1;
+
+static const char* commandNames[NUM_TRACE_COMMANDS] = {"hashSearch", "hashInsert", "hashDelete", "hashCompact"};
+
+TraceWriter::TraceWriter(){
+    binary = false;
+    count = 0;
+}
+
+bool TraceWriter::open(const string& filename, bool binaryFormat){
+    close();
+    file.open(filename.c_str(), ios::binary | ios::trunc);
+    if(!file.is_open()){
+        return false;
+    }
+    binary = binaryFormat;
+    count = 0;
+    if(binary){
+        file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        file.put((char)TRACE_VERSION);
+    }
+    return true;
+}
+
+void TraceWriter::write(TraceCommand command, const string& url){
+    if(!file.is_open()){
+        return;
+    }
+    if(binary){
+        unsigned int len = (unsigned int)url.size();
+        char header[5];
+        header[0] = (char)command;
+        //Length in little-endian order whatever the host is
+        for(int i = 0; i < 4; i++){
+            header[1+i] = (char)((len >> (8*i)) & 0xFF);
+        }
+        file.write(header, sizeof(header));
+        file.write(url.data(), url.size());
+    }
+    else{
+        file << commandNames[command];
+        if(command != TRACE_COMPACT){
+            file << ',' << url;
+        }
+        file << '\n';
+    }
+    count++;
+}
+
+void TraceWriter::close(){
+    if(file.is_open()){
+        file.close();
+    }
+}
+
+bool TraceWriter::isOpen() const{
+    return file.is_open();
+}
+
+long TraceWriter::getCount() const{
+    return count;
+}
+
+bool TraceWriter::isBinaryName(const string& filename){
+    return filename.size() >= 4 && filename.compare(filename.size()-4, 4, ".bin") == 0;
+}
+
+TraceReader::TraceReader(){
+    binary = false;
+    skipped = 0;
+}
+
+bool TraceReader::open(const string& filename){
+    file.open(filename.c_str(), ios::binary);
+    if(!file.is_open()){
+        return false;
+    }
+    skipped = 0;
+    
+    //Binary traces start with the magic; anything else is read as text
+    char magic[sizeof(TRACE_MAGIC)+1];
+    file.read(magic, sizeof(magic));
+    binary = file.gcount() == (streamsize)sizeof(magic) && memcmp(magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0
+             && (unsigned char)magic[sizeof(TRACE_MAGIC)] == TRACE_VERSION;
+    if(!binary){
+        file.clear();
+        file.seekg(0);
+    }
+    return true;
+}
+
+bool TraceReader::next(TraceRecord& record){
+    if(binary){
+        unsigned char header[5];
+        if(!file.read((char*)header, sizeof(header)) || header[0] >= NUM_TRACE_COMMANDS){
+            return false;
+        }
+        unsigned int len = header[1] | (header[2] << 8) | (header[3] << 16) | ((unsigned int)header[4] << 24);
+        record.command = (TraceCommand)header[0];
+        record.url.resize(len);
+        if(len > 0 && !file.read(&record.url[0], len)){
+            return false;
+        }
+        return true;
+    }
+    
+    while(getline(file, line)){
+        if(!line.empty() && line[line.size()-1] == '\r'){
+            line.erase(line.size()-1);
+        }
+        if(line == commandNames[TRACE_COMPACT]){
+            record.command = TRACE_COMPACT;
+            record.url.clear();
+            return true;
+        }
+        
+        size_t pos = line.find(',');
+        if(pos != string::npos && pos+1 < line.size()){
+            for(int c = 0; c < TRACE_COMPACT; c++){
+                if(line.compare(0, pos, commandNames[c]) == 0){
+                    record.command = (TraceCommand)c;
+                    record.url.assign(line, pos+1, string::npos);
+                    return true;
+                }
+            }
+        }
+        skipped++;
+    }
+    return false;
+}
+
+bool TraceReader::isBinary() const{
+    return binary;
+}
+
+long TraceReader::getSkipped() const{
+    return skipped;
+}
+
+const char* TraceReader::commandName(TraceCommand command){
+    return commandNames[command];
+}
+
+TraceReplayer::TraceReplayer(URLHashTable& target) : table(target){
+    chunkSize = 65536;
+}
+
+void TraceReplayer::setChunkSize(int records){
+    chunkSize = records < 1 ? 1 : records;
+}
+
+ReplaySummary TraceReplayer::replay(TraceReader& reader){
+    ReplaySummary summary;
+    for(int c = 0; c < NUM_TRACE_COMMANDS; c++){
+        summary.ops[c] = 0;
+        summary.succeeded[c] = 0;
+    }
+    summary.totalOps = 0;
+    summary.seconds = 0;
+    
+    vector<TraceRecord> records(chunkSize);
+    vector<char> success(chunkSize);
+    bool more = true;
+    
+    while(more){
+        //Read a chunk first so the file is not timed with the table
+        int count = 0;
+        while(count < chunkSize && (more = reader.next(records[count]))){
+            count++;
+        }
+        
+        auto start = chrono::steady_clock::now();
+        for(int i = 0; i < count; i++){
+            const TraceRecord& r = records[i];
+            switch(r.command){
+                case TRACE_SEARCH: success[i] = table.search(r.url).success; break;
+                case TRACE_INSERT: success[i] = table.insert(r.url).success; break;
+                case TRACE_DELETE: success[i] = table.remove(r.url).success; break;
+                default:
+                    table.compactTombstones();
+                    success[i] = true;
+                    break;
+            }
+        }
+        summary.seconds += chrono::duration<double>(chrono::steady_clock::now()-start).count();
+        
+        for(int i = 0; i < count; i++){
+            summary.ops[records[i].command]++;
+            if(success[i]) summary.succeeded[records[i].command]++;
+        }
+        summary.totalOps += count;
+    }
+    return summary;
+}
@@ -0,0 +1,39 @@
+#include "../include/RWLock.h"
+#include <thread>
+
+const int RWLock::WRITER;
+
+RWLock::RWLock() : state(0), writersWaiting(0){}
+
+//A reader that slips in while a writer holds the lock backs its count out
+//again and waits
+void RWLock::lockShared(){
+    while(true){
+        if(writersWaiting.load(memory_order_relaxed)==0){
+            if((state.fetch_add(1, memory_order_acquire) & WRITER)==0){
+                return;
+            }
+            state.fetch_sub(1, memory_order_relaxed);
+        }
+        this_thread::yield();
+    }
+}
+
+void RWLock::unlockShared(){
+    state.fetch_sub(1, memory_order_release);
+}
+
+//Only succeeds once no reader or writer is inside
+void RWLock::lock(){
+    writersWaiting.fetch_add(1, memory_order_relaxed);
+    int expected = 0;
+    while(!state.compare_exchange_weak(expected, WRITER, memory_order_acquire, memory_order_relaxed)){
+        expected = 0;
+        this_thread::yield();
+    }
+    writersWaiting.fetch_sub(1, memory_order_relaxed);
+}
+
+void RWLock::unlock(){
+    state.fetch_sub(WRITER, memory_order_release);
+}
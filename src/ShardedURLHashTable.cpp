@@ -0,0 +1,316 @@
+#include "../include/ShardedURLHashTable.h"
+#include "../include/FastHashes.h"
+#include "../include/HashPolicies.h"
+#include "../include/HashRegistry.h"
+#include "../include/SlotReducer.h"
+#include "../include/EpochReclaimer.h"
+#include <iostream>
+
+//Seed of the routing hash, so it is not the same function as a shard
+//table using wyhash
+static const unsigned long long ROUTE_SEED = 0x5AD5EED5ULL;
+
+static const char* probingName(ProbingMethod probingType){
+    if(probingType==LINEAR_PROBING){
+        return LinearProbePolicy::name();
+    }
+    else if(probingType==QUADRATIC_PROBING){
+        return QuadraticProbePolicy::name();
+    }
+    else{
+        return RobinHoodProbePolicy::name();
+    }
+}
+
+ShardedURLHashTable::ShardedURLHashTable(int tableSize, int shardCount){
+    numShards = shardCount>0 ? shardCount : 1;
+    int shardSize = (tableSize+numShards-1)/numShards;
+    if(shardSize<1){
+        shardSize = 1;
+    }
+    
+    shards = new Shard[numShards];
+    for(int i=0; i<numShards; i++){
+        shards[i].table = new URLHashTable(shardSize);
+        shards[i].readers = new atomic<ReaderStats*>[EpochReclaimer::MAX_THREADS];
+        for(int t=0; t<EpochReclaimer::MAX_THREADS; t++){
+            shards[i].readers[t].store(0, memory_order_relaxed);
+        }
+        shards[i].timerSource = TIMER_STEADY;
+        shards[i].sampleEvery = 1;
+        shards[i].observer = 0;
+    }
+    current_hType = BITWISE_HASH;
+    current_pType = LINEAR_PROBING;
+}
+
+ShardedURLHashTable::~ShardedURLHashTable(){
+    for(int i=0; i<numShards; i++){
+        delete shards[i].table;
+        for(int t=0; t<EpochReclaimer::MAX_THREADS; t++){
+            delete shards[i].readers[t].load(memory_order_relaxed);
+        }
+        delete[] shards[i].readers;
+    }
+    delete[] shards;
+}
+
+//High bits of the routing hash, scaled to the shard count
+int ShardedURLHashTable::shardOf(const string& url) const{
+    unsigned long long hash = FastHashes::wyhash(url.data(), url.length(), ROUTE_SEED);
+    return (int)SlotReducer::mulHigh(hash, (unsigned long long)numShards);
+}
+
+ShardedURLHashTable::Shard& ShardedURLHashTable::shardFor(const string& url){
+    return shards[shardOf(url)];
+}
+
+//The calling thread's search statistics for shard, made on its first search
+//there. Called with the shard's lock held shared, so the timer settings
+//cannot change meanwhile
+ShardedURLHashTable::ReaderStats& ShardedURLHashTable::readerFor(Shard& shard){
+    atomic<ReaderStats*>& slot = shard.readers[EpochReclaimer::threadIndex()];
+    ReaderStats* reader = slot.load(memory_order_acquire);
+    if(!reader){
+        reader = new ReaderStats();
+        reader->timer.setSource(shard.timerSource);
+        reader->timer.setSampleInterval(shard.sampleEvery);
+        slot.store(reader, memory_order_release);
+    }
+    return *reader;
+}
+
+//Insert/delete statistics plus every thread's searches. Called with the
+//shard's lock held alone, so no reader is writing its statistics
+Statistics ShardedURLHashTable::shardStats(Shard& shard){
+    Statistics merged = shard.table->getStats();
+    for(int t=0; t<EpochReclaimer::MAX_THREADS; t++){
+        ReaderStats* reader = shard.readers[t].load(memory_order_acquire);
+        if(reader){
+            merged.merge(reader->stats);
+        }
+    }
+    return merged;
+}
+
+void ShardedURLHashTable::setHashFunction(HashType hashType){
+    current_hType = hashType;
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setHashFunction(hashType);
+    }
+}
+
+void ShardedURLHashTable::setProbingMethod(ProbingMethod probingType){
+    current_pType = probingType;
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setProbingMethod(probingType);
+    }
+}
+
+void ShardedURLHashTable::setMaxLoadFactor(double loadFactor){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setMaxLoadFactor(loadFactor);
+    }
+}
+
+void ShardedURLHashTable::setMigrationBatch(int buckets){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setMigrationBatch(buckets);
+    }
+}
+
+void ShardedURLHashTable::setTombstoneThreshold(double ratio){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setTombstoneThreshold(ratio);
+    }
+}
+
+void ShardedURLHashTable::setKeyEncoding(bool enabled){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setKeyEncoding(enabled);
+    }
+}
+
+void ShardedURLHashTable::setReduction(ReductionMethod method){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setReduction(method);
+    }
+}
+
+bool ShardedURLHashTable::setTimerSource(TimerSource source){
+    bool usable = true;
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        if(!shards[i].table->setTimerSource(source)){
+            usable = false;
+            continue;
+        }
+        shards[i].timerSource = source;
+        for(int t=0; t<EpochReclaimer::MAX_THREADS; t++){
+            ReaderStats* reader = shards[i].readers[t].load(memory_order_relaxed);
+            if(reader){
+                reader->timer.setSource(source);
+            }
+        }
+    }
+    return usable;
+}
+
+void ShardedURLHashTable::setSampleInterval(int every){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setSampleInterval(every);
+        shards[i].sampleEvery = every;
+        for(int t=0; t<EpochReclaimer::MAX_THREADS; t++){
+            ReaderStats* reader = shards[i].readers[t].load(memory_order_relaxed);
+            if(reader){
+                reader->timer.setSampleInterval(every);
+            }
+        }
+    }
+}
+
+void ShardedURLHashTable::setObserver(TableObserver* tableObserver){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->setObserver(tableObserver);
+        shards[i].observer = tableObserver;
+    }
+}
+
+OpResult ShardedURLHashTable::search(const string& url){
+    Shard& shard = shardFor(url);
+    ReadGuard guard(shard.lock);
+    ReaderStats& reader = readerFor(shard);
+    return shard.table->searchShared(url, reader.stats, reader.timer, reader.scratch);
+}
+
+OpResult ShardedURLHashTable::insert(const string& url){
+    Shard& shard = shardFor(url);
+    lock_guard<RWLock> guard(shard.lock);
+    return shard.table->insert(url);
+}
+
+OpResult ShardedURLHashTable::remove(const string& url){
+    Shard& shard = shardFor(url);
+    lock_guard<RWLock> guard(shard.lock);
+    return shard.table->remove(url);
+}
+
+bool ShardedURLHashTable::searchURL(const string& url){
+    Shard& shard = shardFor(url);
+    ReadGuard guard(shard.lock);
+    ReaderStats& reader = readerFor(shard);
+    OpResult result = shard.table->searchShared(url, reader.stats, reader.timer, reader.scratch);
+    if(shard.observer){
+        shard.observer->onSearch(url, result);
+    }
+    return result.success;
+}
+
+bool ShardedURLHashTable::insertURL(const string& url){
+    Shard& shard = shardFor(url);
+    lock_guard<RWLock> guard(shard.lock);
+    return shard.table->insertURL(url);
+}
+
+bool ShardedURLHashTable::deleteURL(const string& url){
+    Shard& shard = shardFor(url);
+    lock_guard<RWLock> guard(shard.lock);
+    return shard.table->deleteURL(url);
+}
+
+//One shard at a time, so the others keep serving while it compacts
+void ShardedURLHashTable::compactTombstones(){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->compactTombstones();
+    }
+}
+
+void ShardedURLHashTable::displayStats(){
+    int minElements = 0, maxElements = 0;
+    for(int i=0; i<numShards; i++){
+        ReadGuard guard(shards[i].lock);
+        int n = shards[i].table->getNumElements();
+        if(i==0 || n<minElements){
+            minElements = n;
+        }
+        if(i==0 || n>maxElements){
+            maxElements = n;
+        }
+    }
+    
+    cout << "HASH STATS" << endl;
+    
+    cout << "\nConfiguration:" << endl;
+    cout << "Hash Function: " << HashRegistry::find(current_hType).name << endl;
+    cout << "Probing Method: " << probingName(current_pType) << endl;
+    cout << "Shards: " << numShards << " (" << minElements << " to " << maxElements
+         << " elements per shard)" << endl;
+    
+    Statistics merged = getStats();
+    merged.display(getSize(), getNumElements(), getLoadFactor(), current_hType);
+    merged.displayCompares();
+    merged.displayPercentiles();
+}
+
+void ShardedURLHashTable::resetStats(){
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        shards[i].table->resetStats();
+        for(int t=0; t<EpochReclaimer::MAX_THREADS; t++){
+            ReaderStats* reader = shards[i].readers[t].load(memory_order_relaxed);
+            if(reader){
+                reader->stats.reset();
+            }
+        }
+    }
+}
+
+double ShardedURLHashTable::getLoadFactor(){
+    return (double)getNumElements()/getSize();
+}
+
+int ShardedURLHashTable::getSize(){
+    int total = 0;
+    for(int i=0; i<numShards; i++){
+        ReadGuard guard(shards[i].lock);
+        total += shards[i].table->getSize();
+    }
+    return total;
+}
+
+int ShardedURLHashTable::getNumElements(){
+    int total = 0;
+    for(int i=0; i<numShards; i++){
+        ReadGuard guard(shards[i].lock);
+        total += shards[i].table->getNumElements();
+    }
+    return total;
+}
+
+int ShardedURLHashTable::getNumShards() const{
+    return numShards;
+}
+
+Statistics ShardedURLHashTable::getStats(){
+    Statistics merged;
+    for(int i=0; i<numShards; i++){
+        lock_guard<RWLock> guard(shards[i].lock);
+        merged.merge(shardStats(shards[i]));
+    }
+    return merged;
+}
+
+Statistics ShardedURLHashTable::getShardStats(int shard){
+    lock_guard<RWLock> guard(shards[shard].lock);
+    return shardStats(shards[shard]);
+}
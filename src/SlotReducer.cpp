@@ -0,0 +1,39 @@
+#include "../include/SlotReducer.h"
+
+SlotReducer::SlotReducer(){
+    size = 1;
+    method = REDUCE_MOD;
+    powerOfTwo = true;
+    mask = 0;
+    reciprocal = 0;
+}
+
+SlotReducer::SlotReducer(int tableSize, ReductionMethod reduction){
+    size = tableSize>0 ? tableSize : 1;
+    method = reduction;
+    powerOfTwo = isPowerOfTwo(size);
+    mask = powerOfTwo ? (unsigned long long)size-1 : 0;
+    reciprocal = ~0ULL/(unsigned long long)size;
+}
+
+bool SlotReducer::isPowerOfTwo(int n){
+    return n>0 && (n & (n-1))==0;
+}
+
+int SlotReducer::nextPowerOfTwo(int n){
+    int p = 1;
+    while(p<n){
+        p <<= 1;
+    }
+    return p;
+}
+
+const char* SlotReducer::methodName(ReductionMethod reduction){
+    if(reduction==REDUCE_FASTRANGE){
+        return "fastrange (multiply-high)";
+    }
+    else if(reduction==REDUCE_POW2){
+        return "power-of-two mask";
+    }
+    return "exact remainder (mask or reciprocal multiply)";
+}
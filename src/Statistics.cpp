@@ -5,23 +5,112 @@ Statistics::Statistics(){
     maxComp = 0;
     numQueries = 0;
     totalTime = 0;
+    numTimed = 0;
+    numGrowths = 0;
+    numMigrationSteps = 0;
+    numMigrated = 0;
+    maxMigrated = 0;
+    migrationTime = 0;
+    numCompactions = 0;
+    numTombstonesRemoved = 0;
+    numBytesReclaimed = 0;
+    compactionTime = 0;
+    numAvoided = 0;
 }
 
-void Statistics::recordQuery(int comp, clock_t time){
+void Statistics::recordQuery(OpKind kind, int comp){
     numComp += comp;
     numQueries++;
-    totalTime += time;
+    probeHist[kind].record(comp);
     
     if(comp>maxComp){
         maxComp = comp;
     }
 }
 
+void Statistics::recordTime(OpKind kind, double seconds){
+    totalTime += seconds;
+    numTimed++;
+    latencyHist[kind].record((unsigned long long)(seconds*1e9+0.5));
+}
+
+void Statistics::recordBatchTime(double seconds, int ops){
+    totalTime += seconds;
+    numTimed += ops;
+}
+
+void Statistics::recordGrowth(){
+    numGrowths++;
+}
+
+void Statistics::recordMigration(int moved, double seconds){
+    numMigrationSteps++;
+    numMigrated += moved;
+    migrationTime += seconds;
+    
+    if(moved>maxMigrated){
+        maxMigrated = moved;
+    }
+}
+
+void Statistics::recordCompaction(int tombstonesRemoved, long bytesReclaimed, double seconds){
+    numCompactions++;
+    numTombstonesRemoved += tombstonesRemoved;
+    numBytesReclaimed += bytesReclaimed;
+    compactionTime += seconds;
+}
+
+void Statistics::recordAvoidedCompares(int avoided){
+    numAvoided += avoided;
+}
+
+void Statistics::merge(const Statistics& other){
+    numComp += other.numComp;
+    numQueries += other.numQueries;
+    totalTime += other.totalTime;
+    numTimed += other.numTimed;
+    numGrowths += other.numGrowths;
+    numMigrationSteps += other.numMigrationSteps;
+    numMigrated += other.numMigrated;
+    migrationTime += other.migrationTime;
+    numCompactions += other.numCompactions;
+    numTombstonesRemoved += other.numTombstonesRemoved;
+    numBytesReclaimed += other.numBytesReclaimed;
+    compactionTime += other.compactionTime;
+    numAvoided += other.numAvoided;
+    for(int k=0; k<NUM_OP_KINDS; k++){
+        probeHist[k].merge(other.probeHist[k]);
+        latencyHist[k].merge(other.latencyHist[k]);
+    }
+    
+    if(other.maxComp>maxComp){
+        maxComp = other.maxComp;
+    }
+    if(other.maxMigrated>maxMigrated){
+        maxMigrated = other.maxMigrated;
+    }
+}
+
 void Statistics::reset(){
     numComp = 0;
     maxComp = 0;
     numQueries = 0;
     totalTime = 0;
+    numTimed = 0;
+    numGrowths = 0;
+    numMigrationSteps = 0;
+    numMigrated = 0;
+    maxMigrated = 0;
+    migrationTime = 0;
+    numCompactions = 0;
+    numTombstonesRemoved = 0;
+    numBytesReclaimed = 0;
+    compactionTime = 0;
+    numAvoided = 0;
+    for(int k=0; k<NUM_OP_KINDS; k++){
+        probeHist[k].reset();
+        latencyHist[k].reset();
+    }
 }
 
 void Statistics::display(int tableSize, int numElements, double loadFactor, HashType hashType){
@@ -33,13 +122,22 @@ void Statistics::display(int tableSize, int numElements, double loadFactor, Hash
     
     if(numQueries>0){
         double avgComp = (double)numComp/numQueries;
-        double avgTime = ((double)totalTime/CLOCKS_PER_SEC)/numQueries;
         
         cout << "\nPerformance Metrics (as required by assignment):" << endl;
         cout << "Average number of comparisons per query: " << avgComp << endl;
         cout << "Maximum number of comparisons by a single query: " << maxComp << endl;
-        cout << fixed << setprecision(8);
-        cout << "Average running time per query: " << avgTime << " seconds" << endl;
+        if(numTimed>0){
+            cout << fixed << setprecision(10);
+            cout << "Average running time per query: " << getAvgTime() << " seconds";
+            cout << fixed << setprecision(1) << " (" << getAvgTime()*1e9 << " ns";
+            if(numTimed!=numQueries){
+                cout << ", " << numTimed << " of " << numQueries << " queries timed";
+            }
+            cout << ")" << endl;
+        }
+        else{
+            cout << "Average running time per query: not timed" << endl;
+        }
         
         cout << fixed << setprecision(2);
         cout << "\nTotal queries processed: " << numQueries << endl;
@@ -49,7 +147,104 @@ void Statistics::display(int tableSize, int numElements, double loadFactor, Hash
     }
 }
 
-int Statistics::getTotalComp() const{
+void Statistics::displayMigration(int bucketsDone, int bucketsTotal){
+    if(numGrowths==0 && bucketsTotal==0){
+        return;
+    }
+    
+    cout << "\nGrowth Metrics:" << endl;
+    cout << "Table growths: " << numGrowths << endl;
+    if(bucketsTotal>0){
+        cout << fixed << setprecision(2);
+        cout << "Migration in progress: " << bucketsDone << "/" << bucketsTotal
+             << " old buckets (" << (100.0*bucketsDone/bucketsTotal) << "%)" << endl;
+    }
+    else{
+        cout << "Migration in progress: none" << endl;
+    }
+    
+    cout << "Entries migrated: " << numMigrated << endl;
+    if(numMigrationSteps>0){
+        cout << fixed << setprecision(4);
+        cout << "Average entries migrated per operation: " << (double)numMigrated/numMigrationSteps << endl;
+        cout << "Maximum entries migrated by a single operation: " << maxMigrated << endl;
+        cout << fixed << setprecision(8);
+        cout << "Average migration time per operation: " << getAvgMigrationTime() << " seconds" << endl;
+    }
+}
+
+void Statistics::displayTombstones(int tombstones, int tableSize, double threshold){
+    cout << "\nTombstone Metrics:" << endl;
+    cout << fixed << setprecision(4);
+    cout << "Tombstones (DELETED slots): " << tombstones << endl;
+    cout << "Tombstone density: " << (double)tombstones/tableSize << endl;
+    if(threshold>0){
+        cout << "Compaction threshold: " << threshold << endl;
+    }
+    else{
+        cout << "Compaction threshold: disabled" << endl;
+    }
+    
+    cout << "Compactions run: " << numCompactions << endl;
+    if(numCompactions>0){
+        cout << "Tombstones reclaimed: " << numTombstonesRemoved << endl;
+        cout << "Key arena bytes reclaimed: " << numBytesReclaimed << endl;
+        cout << fixed << setprecision(8);
+        cout << "Average compaction time: " << compactionTime/numCompactions << " seconds" << endl;
+    }
+}
+
+void Statistics::displayCompares(){
+    cout << "\nKey Comparison Metrics:" << endl;
+    cout << "Occupied slots compared: " << numComp << endl;
+    cout << "String compares avoided (inline hash/length/tag): " << numAvoided << endl;
+    if(numComp>0){
+        cout << fixed << setprecision(2);
+        cout << "Share of slot comparisons without a string compare: " << (100.0*numAvoided/numComp) << "%" << endl;
+    }
+}
+
+//p50/p90/p99/p99.9 and max of probes and latency for each operation type
+//that has run. Latency rows cover the individually timed operations only
+void Statistics::displayPercentiles(){
+    static const double PERCENTILES[] = {50, 90, 99, 99.9};
+    
+    cout << "\nPercentile Metrics:" << endl;
+    cout << left << setw(14) << "Operation" << setw(13) << "Metric" << right << setw(10) << "Count"
+         << setw(10) << "p50" << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "p99.9"
+         << setw(10) << "Max" << endl;
+    
+    for(int k=0; k<NUM_OP_KINDS; k++){
+        const LogHistogram* rows[] = {&probeHist[k], &latencyHist[k]};
+        const char* metrics[] = {"probes", "latency (ns)"};
+        for(int r=0; r<2; r++){
+            if(rows[r]->getCount()==0){
+                continue;
+            }
+            cout << left << setw(14) << opKindName((OpKind)k) << setw(13) << metrics[r]
+                 << right << setw(10) << rows[r]->getCount();
+            for(int p=0; p<4; p++){
+                cout << setw(10) << rows[r]->percentile(PERCENTILES[p]);
+            }
+            cout << setw(10) << rows[r]->getMax() << endl;
+        }
+    }
+}
+
+//Memory per stored key: the slot array plus the key arena, next to the
+//same table laid out with a std::string in every slot
+void Statistics::displayKeyStorage(int numKeys, long slotBytes, long arenaBytes, long deadBytes, long stringLayoutBytes){
+    cout << "\nKey Storage Metrics:" << endl;
+    cout << "Slot array: " << slotBytes << " bytes" << endl;
+    cout << "Key arena and host dictionary: " << arenaBytes << " bytes (" << deadBytes << " from deleted keys)" << endl;
+    if(numKeys>0){
+        cout << fixed << setprecision(2);
+        cout << "Bytes per key (arena keys): " << (double)(slotBytes+arenaBytes)/numKeys << endl;
+        cout << "Bytes per key (std::string per slot): " << (double)stringLayoutBytes/numKeys << endl;
+    }
+}
+
+long long Statistics::getTotalComp() const{
     return numComp;
 }
 
@@ -57,7 +252,7 @@ int Statistics::getMaxComp() const{
     return maxComp;
 }
 
-int Statistics::getNumQueries() const{
+long long Statistics::getNumQueries() const{
     return numQueries;
 }
 
@@ -69,9 +264,60 @@ double Statistics::getAvgComparisons() const{
 }
 
 double Statistics::getAvgTime() const{
-    if(numQueries > 0){
-        return ((double)totalTime / CLOCKS_PER_SEC) / numQueries;
+    if(numTimed > 0){
+        return totalTime / numTimed;
+    }
+    return 0.0;
+}
+
+long long Statistics::getNumTimed() const{
+    return numTimed;
+}
+
+const LogHistogram& Statistics::getProbeHistogram(OpKind kind) const{
+    return probeHist[kind];
+}
+
+const LogHistogram& Statistics::getLatencyHistogram(OpKind kind) const{
+    return latencyHist[kind];
+}
+
+int Statistics::getNumGrowths() const{
+    return numGrowths;
+}
+
+int Statistics::getNumMigrated() const{
+    return numMigrated;
+}
+
+int Statistics::getMaxMigrated() const{
+    return maxMigrated;
+}
+
+double Statistics::getAvgMigrationTime() const{
+    if(numMigrationSteps > 0){
+        return migrationTime / numMigrationSteps;
     }
     return 0.0;
 }
 
+int Statistics::getNumCompactions() const{
+    return numCompactions;
+}
+
+long long Statistics::getAvoidedCompares() const{
+    return numAvoided;
+}
+
+const char* Statistics::opKindName(OpKind kind){
+    if(kind==OP_SEARCH_HIT){
+        return "Search hit";
+    }
+    else if(kind==OP_SEARCH_MISS){
+        return "Search miss";
+    }
+    else if(kind==OP_INSERT){
+        return "Insert";
+    }
+    return "Delete";
+}
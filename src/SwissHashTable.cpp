@@ -0,0 +1,262 @@
+#include "../include/SwissHashTable.h"
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWISS_USE_SSE2 1
+#endif
+
+const int SwissHashTable::GROUP_WIDTH;
+const signed char SwissHashTable::CTRL_EMPTY;
+const signed char SwissHashTable::CTRL_DELETED;
+
+//Index of the lowest set bit in a non-zero group mask
+static int lowestBit(unsigned int mask){
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while((mask & 1u)==0){
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+SwissHashTable::SwissHashTable(int tableSize){
+    //Round up to whole groups so every SIMD load stays inside the table
+    numGroups = (tableSize+GROUP_WIDTH-1)/GROUP_WIDTH;
+    if(numGroups<1){
+        numGroups = 1;
+    }
+    size = numGroups*GROUP_WIDTH;
+    groupReducer = SlotReducer(numGroups, REDUCE_MOD);
+    numElements = 0;
+    ctrl.assign(size, CTRL_EMPTY);
+    slots.resize(size);
+    current_hType = BITWISE_HASH;
+    hashAlgo = &HashRegistry::find(current_hType);
+    observer = 0;
+}
+
+SwissHashTable::~SwissHashTable(){}
+
+void SwissHashTable::setHashFunction(HashType hashType){
+    current_hType = hashType;
+    hashAlgo = &HashRegistry::find(hashType);
+}
+
+bool SwissHashTable::setTimerSource(TimerSource source){
+    return timer.setSource(source);
+}
+
+void SwissHashTable::setSampleInterval(int every){
+    timer.setSampleInterval(every);
+}
+
+void SwissHashTable::setObserver(TableObserver* tableObserver){
+    observer = tableObserver;
+}
+
+//64-bit hash: the low 7 bits become the fingerprint (H2) and the remaining
+//bits select the home group (H1)
+unsigned long long SwissHashTable::hashURL(const string& url){
+    return hashAlgo->hash64(hashFunc, url.data(), url.length());
+}
+
+unsigned int SwissHashTable::matchFingerprint(int group, signed char h2) const{
+    const signed char* g = &ctrl[group*GROUP_WIDTH];
+#ifdef SWISS_USE_SSE2
+    __m128i bytes = _mm_loadu_si128((const __m128i*)g);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h2)));
+#else
+    unsigned int mask = 0;
+    for(int i=0; i<GROUP_WIDTH; i++){
+        if(g[i]==h2){
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+unsigned int SwissHashTable::matchEmpty(int group) const{
+    return matchFingerprint(group, CTRL_EMPTY);
+}
+
+unsigned int SwissHashTable::matchEmptyOrDeleted(int group) const{
+    const signed char* g = &ctrl[group*GROUP_WIDTH];
+#ifdef SWISS_USE_SSE2
+    //Empty and deleted are the only control bytes with the sign bit set
+    __m128i bytes = _mm_loadu_si128((const __m128i*)g);
+    return (unsigned int)_mm_movemask_epi8(bytes);
+#else
+    unsigned int mask = 0;
+    for(int i=0; i<GROUP_WIDTH; i++){
+        if(g[i]<0){
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+//Returns the slot holding url, or -1. Only slots whose fingerprint matches
+//are compared as strings
+int SwissHashTable::findSlot(const string& url, unsigned long long hash, int& comp){
+    signed char h2 = (signed char)(hash & 0x7F);
+    int group = groupReducer.reduce(hash >> 7);
+    
+    for(int i=0; i<numGroups; i++){
+        unsigned int mask = matchFingerprint(group, h2);
+        while(mask){
+            int idx = group*GROUP_WIDTH + lowestBit(mask);
+            comp++;  //Count URL string comparison
+            if(slots[idx]==url){
+                return idx;
+            }
+            mask &= mask-1;
+        }
+        
+        //An empty slot in the group means the URL was never pushed further
+        if(matchEmpty(group)){
+            return -1;
+        }
+        
+        group = group+1<numGroups ? group+1 : 0;
+    }
+    
+    return -1;
+}
+
+OpResult SwissHashTable::search(const string& url){
+    bool timed = timer.sample();
+    unsigned long long start = timed ? timer.now() : 0;
+    OpResult result;
+    
+    unsigned long long hash = hashURL(url);
+    result.slot = findSlot(url, hash, result.probes);
+    result.success = result.slot!=-1;
+    
+    OpKind kind = result.success ? OP_SEARCH_HIT : OP_SEARCH_MISS;
+    if(timed){
+        result.elapsed = timer.seconds(start, timer.now());
+        stats.recordTime(kind, result.elapsed);
+    }
+    stats.recordQuery(kind, result.probes);
+    return result;
+}
+
+OpResult SwissHashTable::insert(const string& url){
+    bool timed = timer.sample();
+    unsigned long long start = timed ? timer.now() : 0;
+    OpResult result;
+    
+    unsigned long long hash = hashURL(url);
+    result.slot = findSlot(url, hash, result.probes);
+    
+    //Take the first empty or deleted slot along the same group sequence
+    int group = groupReducer.reduce(hash >> 7);
+    for(int i=0; result.slot==-1 && i<numGroups && numElements<size; i++){
+        unsigned int mask = matchEmptyOrDeleted(group);
+        if(mask){
+            int idx = group*GROUP_WIDTH + lowestBit(mask);
+            ctrl[idx] = (signed char)(hash & 0x7F);
+            slots[idx] = url;
+            numElements++;
+            result.success = true;
+            result.slot = idx;
+        }
+        group = group+1<numGroups ? group+1 : 0;
+    }
+    
+    if(timed){
+        result.elapsed = timer.seconds(start, timer.now());
+        stats.recordTime(OP_INSERT, result.elapsed);
+    }
+    stats.recordQuery(OP_INSERT, result.probes);
+    return result;
+}
+
+OpResult SwissHashTable::remove(const string& url){
+    bool timed = timer.sample();
+    unsigned long long start = timed ? timer.now() : 0;
+    OpResult result;
+    
+    unsigned long long hash = hashURL(url);
+    result.slot = findSlot(url, hash, result.probes);
+    
+    if(result.slot!=-1){
+        //If the group still has an empty slot no probe ever continued past
+        //it, so the slot can go straight back to empty
+        int group = result.slot/GROUP_WIDTH;
+        ctrl[result.slot] = matchEmpty(group) ? CTRL_EMPTY : CTRL_DELETED;
+        slots[result.slot] = "";
+        numElements--;
+        result.success = true;
+    }
+    
+    if(timed){
+        result.elapsed = timer.seconds(start, timer.now());
+        stats.recordTime(OP_DELETE, result.elapsed);
+    }
+    stats.recordQuery(OP_DELETE, result.probes);
+    return result;
+}
+
+bool SwissHashTable::searchURL(const string& url){
+    OpResult result = search(url);
+    if(observer){
+        observer->onSearch(url, result);
+    }
+    return result.success;
+}
+
+bool SwissHashTable::insertURL(const string& url){
+    OpResult result = insert(url);
+    if(observer){
+        observer->onInsert(url, result);
+    }
+    return result.success;
+}
+
+bool SwissHashTable::deleteURL(const string& url){
+    OpResult result = remove(url);
+    if(observer){
+        observer->onDelete(url, result);
+    }
+    return result.success;
+}
+
+void SwissHashTable::displayStats(){
+    cout << "HASH STATS" << endl;
+    
+    cout << "\nConfiguration:" << endl;
+    cout << "Hash Function: " << hashAlgo->name << endl;
+    
+    cout << "Probing Method: Swiss Table (" << GROUP_WIDTH << "-wide control groups)" << endl;
+    
+    stats.display(size, numElements, getLoadFactor(), current_hType);
+    stats.displayPercentiles();
+}
+
+void SwissHashTable::resetStats(){
+    stats.reset();
+}
+
+double SwissHashTable::getLoadFactor(){
+    return (double)numElements/size;
+}
+
+int SwissHashTable::getSize(){
+    return size;
+}
+
+int SwissHashTable::getNumElements(){
+    return numElements;
+}
+
+const Statistics& SwissHashTable::getStats() const{
+    return stats;
+}
@@ -0,0 +1,47 @@
+#include "../include/TableObserver.h"
+#include <iostream>
+
+TableObserver::~TableObserver(){}
+
+void TableObserver::onSearch(const string&, const OpResult&){}
+
+void TableObserver::onInsert(const string&, const OpResult&){}
+
+void TableObserver::onDelete(const string&, const OpResult&){}
+
+void TableObserver::onTableFull(const string&){}
+
+void ConsoleObserver::onSearch(const string& url, const OpResult& result){
+    if(result.success){
+        cout << "\n\"" << url << "\" is a HIT - found in the hash table." << endl;
+    }
+    else{
+        cout << "\n\"" << url << "\" is NOT found in the hash table." << endl;
+    }
+}
+
+void ConsoleObserver::onInsert(const string& url, const OpResult& result){
+    if(result.success){
+        return;
+    }
+    
+    if(result.slot != -1){
+        cout << "\n\"" << url << "\" is a HIT - already exists in the hash table." << endl;
+    }
+    else{
+        onTableFull(url);
+    }
+}
+
+void ConsoleObserver::onDelete(const string& url, const OpResult& result){
+    if(result.success){
+        cout << "\"" << url << "\" is deleted from hash table." << endl;
+    }
+    else{
+        cout << "\"" << url << "\" is NOT deleted from hash table." << endl;
+    }
+}
+
+void ConsoleObserver::onTableFull(const string&){
+    cout << "Error: Hash table is full!" << endl;
+}
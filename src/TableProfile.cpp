@@ -0,0 +1,238 @@
+#include "../include/TableProfile.h"
+#include <iomanip>
+#include <algorithm>
+
+TableProfile::TableProfile(){
+    begin(0, 0);
+}
+
+void TableProfile::begin(int size, int topClusters){
+    tableSize = size;
+    occupied = 0;
+    tombstones = 0;
+    pendingMigration = 0;
+    numRuns = 0;
+    runsWithTombstones = 0;
+    runLengths.assign(1, 0);
+    displacement.assign(1, 0);
+    int segments = size<NUM_SEGMENTS ? size : NUM_SEGMENTS;
+    segmentOccupied.assign(segments, 0);
+    segmentTombstones.assign(segments, 0);
+    largest.clear();
+    topK = topClusters<0 ? 0 : topClusters;
+    inRun = false;
+    first.start = 0;
+    first.length = 0;
+    first.tombstones = 0;
+}
+
+void TableProfile::slot(int idx, SlotStatus status, int dist){
+    if(status==EMPTY){
+        if(inRun){
+            //A run from slot 0 may continue the one that wraps at the end
+            if(current.start==0){
+                first = current;
+            }
+            else{
+                closeRun(current);
+            }
+            inRun = false;
+        }
+        return;
+    }
+    
+    if(!inRun){
+        current.start = idx;
+        current.length = 0;
+        current.tombstones = 0;
+        inRun = true;
+    }
+    current.length++;
+    
+    int segment = (int)((long long)idx*segmentOccupied.size()/tableSize);
+    if(status==OCCUPIED){
+        occupied++;
+        segmentOccupied[segment]++;
+        if(dist>=(int)displacement.size()){
+            displacement.resize(dist+1, 0);
+        }
+        displacement[dist]++;
+    }
+    else{
+        tombstones++;
+        current.tombstones++;
+        segmentTombstones[segment]++;
+    }
+}
+
+void TableProfile::finish(){
+    if(inRun){
+        if(first.length>0){
+            current.length += first.length;
+            current.tombstones += first.tombstones;
+            first.length = 0;
+        }
+        closeRun(current);
+        inRun = false;
+    }
+    if(first.length>0){
+        closeRun(first);
+        first.length = 0;
+    }
+}
+
+void TableProfile::closeRun(const ClusterRun& run){
+    numRuns++;
+    if(run.tombstones>0){
+        runsWithTombstones++;
+    }
+    if(run.length>=(int)runLengths.size()){
+        runLengths.resize(run.length+1, 0);
+    }
+    runLengths[run.length]++;
+    
+    //Top runs by length, kept sorted; ties keep the lower slot first
+    if((int)largest.size()<topK || (topK>0 && run.length>largest.back().length)){
+        vector<ClusterRun>::iterator pos = largest.begin();
+        while(pos!=largest.end() && pos->length>=run.length){
+            ++pos;
+        }
+        largest.insert(pos, run);
+        if((int)largest.size()>topK){
+            largest.pop_back();
+        }
+    }
+}
+
+double TableProfile::meanRunLength() const{
+    return numRuns>0 ? (double)(occupied+tombstones)/numRuns : 0;
+}
+
+int TableProfile::longestRun() const{
+    return (int)runLengths.size()-1;
+}
+
+double TableProfile::meanDisplacement() const{
+    double total = 0;
+    for(size_t d=0; d<displacement.size(); d++){
+        total += (double)d*displacement[d];
+    }
+    return occupied>0 ? total/occupied : 0;
+}
+
+int TableProfile::maxDisplacement() const{
+    for(size_t d=displacement.size(); d>0; d--){
+        if(displacement[d-1]>0) return (int)d-1;
+    }
+    return 0;
+}
+
+//A miss starting k slots before the end of a run examines k+1 slots (the
+//last one empty), so a run of L slots costs L(L+1)/2 + L over its starts
+double TableProfile::linearMissCost() const{
+    if(tableSize==0) return 0;
+    double total = tableSize-occupied-tombstones;
+    for(size_t len=1; len<runLengths.size(); len++){
+        total += runLengths[len]*(len*(len+1)/2.0+len);
+    }
+    return total/tableSize;
+}
+
+double TableProfile::uniformMissCost() const{
+    if(tableSize==0) return 0;
+    double fill = (double)(occupied+tombstones)/tableSize;
+    if(fill>=1) return tableSize;
+    return 0.5*(1+1/((1-fill)*(1-fill)));
+}
+
+//Counts grouped into ranges that double in width: [lo, hi] per line
+static void printRanges(const vector<long>& counts, int firstValue, const char* heading, bool withSlots){
+    cout << "  " << left << setw(12) << heading << right << setw(12) << "Count";
+    if(withSlots) cout << setw(12) << "Slots";
+    cout << endl;
+    
+    long last = (long)counts.size()-1;
+    for(long lo=firstValue, hi=firstValue; lo<=last; lo=hi+1, hi=max(lo, 2*hi)){
+        long top = hi<last ? hi : last;
+        long count = 0, slots = 0;
+        for(long v=lo; v<=top; v++){
+            count += counts[v];
+            slots += counts[v]*v;
+        }
+        if(count==0) continue;
+        
+        string range = lo==top ? to_string(lo) : to_string(lo)+"-"+to_string(top);
+        cout << "  " << left << setw(12) << range << right << setw(12) << count;
+        if(withSlots) cout << setw(12) << slots;
+        cout << endl;
+    }
+}
+
+//One digit per region: its value in tenths of scale ('.' for zero)
+static string regionMap(const vector<int>& values, double scale){
+    string map;
+    for(size_t i=0; i<values.size(); i++){
+        if(values[i]==0 || scale<=0){
+            map += '.';
+            continue;
+        }
+        int tenths = (int)(values[i]*10/scale);
+        map += (char)('0'+(tenths>9 ? 9 : tenths));
+    }
+    return map;
+}
+
+void TableProfile::display() const{
+    cout << "\nTable Profile (" << tableSize << " slots):" << endl;
+    if(tableSize==0) return;
+    
+    cout << fixed << setprecision(2);
+    cout << "Occupied: " << occupied << " (" << 100.0*occupied/tableSize << "%), tombstones: " << tombstones
+         << " (" << 100.0*tombstones/tableSize << "%), empty: " << tableSize-occupied-tombstones << endl;
+    if(pendingMigration>0){
+        cout << "Not yet migrated from the previous table: " << pendingMigration << endl;
+    }
+    
+    cout << "\nCluster runs: " << numRuns << ", mean " << meanRunLength() << " slots, longest " << longestRun() << endl;
+    printRanges(runLengths, 1, "Length", true);
+    cout << "Linear miss scan: " << linearMissCost() << " slots from these runs, " << uniformMissCost()
+         << " under uniform hashing" << endl;
+    
+    cout << "\nDisplacement from home (probe steps): mean " << meanDisplacement() << ", max " << maxDisplacement() << endl;
+    printRanges(displacement, 0, "Steps", false);
+    
+    int regionSlots = (tableSize+(int)segmentOccupied.size()-1)/(int)segmentOccupied.size();
+    int busiest = segmentTombstones.empty() ? 0 : *max_element(segmentTombstones.begin(), segmentTombstones.end());
+    cout << "\nTombstones: in " << runsWithTombstones << " of " << numRuns << " runs, at most "
+         << busiest << " in one region" << endl;
+    cout << "Occupancy by region (" << segmentOccupied.size() << " x " << regionSlots << " slots, tenths full):" << endl;
+    cout << "  " << regionMap(segmentOccupied, regionSlots) << endl;
+    cout << "Tombstones by region (tenths of the busiest):" << endl;
+    cout << "  " << regionMap(segmentTombstones, busiest+1e-9) << endl;
+    
+    if(!largest.empty()){
+        cout << "\nLargest clusters:" << endl;
+        for(size_t i=0; i<largest.size(); i++){
+            const ClusterRun& run = largest[i];
+            cout << "  Slots " << run.start << "-" << (run.start+run.length-1)%tableSize << ": " << run.length
+                 << " slots, " << run.tombstones << " tombstones" << endl;
+        }
+    }
+}
+
+void TableProfile::writeCSV(ostream& out) const{
+    out << "Metric,Key,Count,Tombstones\n";
+    for(size_t len=1; len<runLengths.size(); len++){
+        if(runLengths[len]>0) out << "RunLength," << len << "," << runLengths[len] << ",\n";
+    }
+    for(size_t d=0; d<displacement.size(); d++){
+        if(displacement[d]>0) out << "Displacement," << d << "," << displacement[d] << ",\n";
+    }
+    for(size_t s=0; s<segmentOccupied.size(); s++){
+        out << "Segment," << (long long)s*tableSize/segmentOccupied.size() << "," << segmentOccupied[s] << ","
+            << segmentTombstones[s] << "\n";
+    }
+    for(size_t i=0; i<largest.size(); i++){
+        out << "LargestCluster," << largest[i].start << "," << largest[i].length << "," << largest[i].tombstones << "\n";
+    }
+}
@@ -1,260 +1,266 @@
 #include "../include/URLHashTable.h"
-#include <iostream>
+#include "../include/BasicURLHashTable.h"
 
-URLHashTable::URLHashTable(int tableSize){
-    size = tableSize;
-    numElements = 0;
-    table.resize(size);
-    current_hType = BITWISE_HASH;
-    current_pType = LINEAR_PROBING;
-}
-
-URLHashTable::~URLHashTable(){}
-
-void URLHashTable::setHashFunction(HashType hashType){
-    current_hType = hashType;
-}
-
-void URLHashTable::setProbingMethod(ProbingMethod probingType){
-    current_pType = probingType;
-}
-
-int URLHashTable::probe(unsigned long hash, int i){
-    if(current_pType==LINEAR_PROBING){
-        return (hash+i)%size;
+template <typename HashPolicy>
+static URLTableEngine* createWithHash(ProbingMethod probingType, int tableSize){
+    if(probingType==LINEAR_PROBING){
+        return new BasicURLHashTable<HashPolicy, LinearProbePolicy>(tableSize);
+    }
+    else if(probingType==QUADRATIC_PROBING){
+        return new BasicURLHashTable<HashPolicy, QuadraticProbePolicy>(tableSize);
     }
     else{
-        return (hash+i*i)%size;
+        return new BasicURLHashTable<HashPolicy, RobinHoodProbePolicy>(tableSize);
     }
 }
 
-bool URLHashTable::searchURL(const string& url){
-    clock_t start = clock();
-    int comp = 0;
-    bool found = false;
-    
-    unsigned long hash;
-    if(current_hType==BITWISE_HASH){
-        hash = hashFunc.bitwiseHash(url, size);
+URLTableEngine* URLHashTable::createEngine(HashType hashType, ProbingMethod probingType, int tableSize){
+    if(hashType==BITWISE_HASH){
+        return createWithHash<BitwiseHashPolicy>(probingType, tableSize);
     }
-    else if(current_hType==POLYNOMIAL_HASH){
-        hash = hashFunc.polynomialHash(url, size);
+    else if(hashType==POLYNOMIAL_HASH){
+        return createWithHash<PolynomialHashPolicy>(probingType, tableSize);
     }
-    else{
-        hash = hashFunc.universalHash(url, size);
+    else if(hashType==UNIVERSAL_HASH){
+        return createWithHash<UniversalHashPolicy>(probingType, tableSize);
     }
-    
-    int idx = hash;
-    int i = 0;
-    
-    while(i<size){
-        if(table[idx].status==EMPTY){
-            break;
-        }
-        
-        if(table[idx].status==OCCUPIED){
-            comp++;  //Count URL string comparison
-            if(table[idx].url==url){
-                found = true;
-                break;
-            }
-        }
-        
-        i++;
-        idx = probe(hash, i);
+    else if(hashType==BITWISE_WIDE_HASH){
+        return createWithHash<BitwiseWideHashPolicy>(probingType, tableSize);
     }
-    
-    clock_t end = clock();
-    stats.recordQuery(comp, end-start);
-    
-    if(found){
-        cout << "\n\"" << url << "\" is a HIT - found in the hash table." << endl;
+    else if(hashType==POLYNOMIAL_WIDE_HASH){
+        return createWithHash<PolynomialWideHashPolicy>(probingType, tableSize);
     }
-    else{
-        cout << "\n\"" << url << "\" is NOT found in the hash table." << endl;
+    else if(hashType==UNIVERSAL_WIDE_HASH){
+        return createWithHash<UniversalWideHashPolicy>(probingType, tableSize);
     }
-    
-    return found;
-}
-
-bool URLHashTable::insertURL(const string& url){
-    clock_t start = clock();
-    int comp = 0;
-    
-    unsigned long hash;
-    if(current_hType==BITWISE_HASH){
-        hash = hashFunc.bitwiseHash(url, size);
+    else if(hashType==XXHASH64_HASH){
+        return createWithHash<XXHash64HashPolicy>(probingType, tableSize);
     }
-    else if(current_hType==POLYNOMIAL_HASH){
-        hash = hashFunc.polynomialHash(url, size);
+    else if(hashType==WYHASH_HASH){
+        return createWithHash<WyhashHashPolicy>(probingType, tableSize);
     }
-    else{
-        hash = hashFunc.universalHash(url, size);
+    else if(hashType==FNV1A_HASH){
+        return createWithHash<Fnv1aHashPolicy>(probingType, tableSize);
     }
-    
-    int idx = hash;
-    int i = 0;
-    int firstAvailable = -1;
-    
-    //Search for URL and track first available slot
-    while(i<size){
-        if(table[idx].status==EMPTY){
-            //Found empty slot - URL doesn't exist
-            if(firstAvailable == -1){
-                firstAvailable = idx;
-            }
-            break;
-        }
-        
-        if(table[idx].status==DELETED && firstAvailable == -1){
-            // Remember first deleted slot for insertion
-            firstAvailable = idx;
-        }
-        
-        if(table[idx].status==OCCUPIED){
-            comp++;  // Count URL string comparison
-            if(table[idx].url==url){
-                clock_t end = clock();
-                stats.recordQuery(comp, end-start);
-                cout << "\n\"" << url << "\" is a HIT - already exists in the hash table." << endl;
-                return false;
-            }
-        }
-        
-        i++;
-        idx = probe(hash, i);
+    else if(hashType==MURMUR3_HASH){
+        return createWithHash<Murmur3HashPolicy>(probingType, tableSize);
     }
-    
-    // Insert URL at first available slot
-    if(firstAvailable != -1){
-        table[firstAvailable].url = url;
-        table[firstAvailable].status = OCCUPIED;
-        numElements++;
-        
-        clock_t end = clock();
-        stats.recordQuery(comp, end-start);
-        return true;
+    else{
+        return createWithHash<Crc32cHashPolicy>(probingType, tableSize);
     }
-    
-    cout << "Error: Hash table is full!" << endl;
-    clock_t end = clock();
-    stats.recordQuery(comp, end-start);
-    return false;
 }
 
-bool URLHashTable::deleteURL(const string& url){
-    clock_t start = clock();
-    int comp = 0;
-    bool deleted = false;
-    
-    unsigned long hash;
-    if(current_hType==BITWISE_HASH){
-        hash = hashFunc.bitwiseHash(url, size);
-    }
-    else if(current_hType==POLYNOMIAL_HASH){
-        hash = hashFunc.polynomialHash(url, size);
-    }
-    else{
-        hash = hashFunc.universalHash(url, size);
-    }
-    
-    int idx = hash;
-    int i = 0;
+URLHashTable::URLHashTable(int tableSize){
+    current_hType = BITWISE_HASH;
+    current_pType = LINEAR_PROBING;
+    maxLoadFactor = 0.0;
+    migrateBatch = 4;
+    tombstoneThreshold = 0.2;
+    keyEncoding = false;
+    reduction = REDUCE_MOD;
+    prefetch = true;
+    timerSource = TIMER_STEADY;
+    sampleInterval = 1;
+    observer = 0;
+    engine = createEngine(current_hType, current_pType, tableSize);
+}
+
+URLHashTable::~URLHashTable(){
+    delete engine;
+}
+
+//Swap in the engine for the current configuration, carrying over the
+//stored URLs, the settings and the statistics gathered so far. A quadratic
+//probe path can find no free slot for a URL at the current size; the URLs
+//are then placed again in the next power-of-two size, whose probe sequence
+//reaches every slot, so a switch never drops a stored URL
+void URLHashTable::rebuildEngine(){
+    vector<string> urls;
+    engine->collectURLs(urls);
     
-    while(i<size){
-        if(table[idx].status==EMPTY){
-            break;
-        }
+    int size = engine->getSize();
+    URLTableEngine* next = 0;
+    while(!next){
+        next = createEngine(current_hType, current_pType, size);
+        next->setMaxLoadFactor(maxLoadFactor);
+        next->setMigrationBatch(migrateBatch);
+        next->setTombstoneThreshold(tombstoneThreshold);
+        next->setKeyEncoding(keyEncoding);
+        next->setReduction(reduction);
+        next->setPrefetch(prefetch);
+        next->setTimerSource(timerSource);
+        next->setSampleInterval(sampleInterval);
         
-        if(table[idx].status==OCCUPIED){
-            comp++;  //Count URL string comparison
-            if(table[idx].url==url){
-                table[idx].status = DELETED;
-                table[idx].url = "";
-                numElements--;
-                deleted = true;
+        for(size_t i=0; i<urls.size(); i++){
+            if(!next->insert(urls[i]).success){
+                delete next;
+                next = 0;
+                size = SlotReducer::nextPowerOfTwo(size+1);
                 break;
             }
         }
-        
-        i++;
-        idx = probe(hash, i);
     }
+    next->setStats(engine->getStats());
+    next->setObserver(observer);
     
-    clock_t end = clock();
-    stats.recordQuery(comp, end-start);
-    
-    if(deleted){
-        cout << "\"" << url << "\" is deleted from hash table." << endl;
-    }
-    else{
-        cout << "\"" << url << "\" is NOT deleted from hash table." << endl;
-    }
-    
-    return deleted;
+    delete engine;
+    engine = next;
 }
 
-void URLHashTable::displayTable(){
-    cout << "\nHash Table Contents" << endl;
-    for(int i=0; i<size; i++){
-        cout << "Slot[" << i << "]: ";
-        if(table[i].status==OCCUPIED){
-            cout << table[i].url;
-        }
-        else if(table[i].status==DELETED){
-            cout << "[DELETED]";
-        }
-        else{
-            cout << "[EMPTY]";
-        }
-        cout << endl;
+void URLHashTable::setHashFunction(HashType hashType){
+    if(hashType!=current_hType){
+        current_hType = hashType;
+        rebuildEngine();
     }
 }
 
-void URLHashTable::displayStats(){
-    cout << "HASH STATS" << endl;
-    
-    cout << "\nConfiguration:" << endl;
-    cout << "Hash Function: ";
-    if(current_hType==BITWISE_HASH){
-        cout << "Bitwise Mixing Hash" << endl;
-    }
-    else if(current_hType==POLYNOMIAL_HASH){
-        cout << "Polynomial Rolling Hash" << endl;
-    }
-    else{
-        cout << "Universal Hashing" << endl;
-    }
-    
-    cout << "Probing Method: ";
-    if(current_pType==LINEAR_PROBING){
-        cout << "Linear Probing" << endl;
+void URLHashTable::setProbingMethod(ProbingMethod probingType){
+    if(probingType!=current_pType){
+        current_pType = probingType;
+        rebuildEngine();
     }
-    else{
-        cout << "Quadratic Probing" << endl;
+}
+
+void URLHashTable::setMaxLoadFactor(double loadFactor){
+    maxLoadFactor = loadFactor;
+    engine->setMaxLoadFactor(loadFactor);
+}
+
+void URLHashTable::setMigrationBatch(int buckets){
+    migrateBatch = buckets;
+    engine->setMigrationBatch(buckets);
+}
+
+void URLHashTable::setTombstoneThreshold(double ratio){
+    tombstoneThreshold = ratio;
+    engine->setTombstoneThreshold(ratio);
+}
+
+void URLHashTable::setKeyEncoding(bool enabled){
+    keyEncoding = enabled;
+    engine->setKeyEncoding(enabled);
+}
+
+void URLHashTable::setReduction(ReductionMethod method){
+    reduction = method;
+    engine->setReduction(method);
+}
+
+void URLHashTable::setPrefetch(bool enabled){
+    prefetch = enabled;
+    engine->setPrefetch(enabled);
+}
+
+bool URLHashTable::setTimerSource(TimerSource source){
+    if(!engine->setTimerSource(source)){
+        return false;
     }
-    
-    stats.display(size, numElements, getLoadFactor(), current_hType);
+    timerSource = source;
+    return true;
+}
+
+void URLHashTable::setSampleInterval(int every){
+    sampleInterval = every;
+    engine->setSampleInterval(every);
+}
+
+void URLHashTable::setObserver(TableObserver* tableObserver){
+    observer = tableObserver;
+    engine->setObserver(tableObserver);
+}
+
+OpResult URLHashTable::search(const string& url){
+    return engine->search(url);
+}
+
+OpResult URLHashTable::insert(const string& url){
+    return engine->insert(url);
+}
+
+OpResult URLHashTable::remove(const string& url){
+    return engine->remove(url);
+}
 
+OpResult URLHashTable::searchShared(const string& url, Statistics& readerStats, OpTimer& readerTimer, string& scratch){
+    return engine->searchShared(url, readerStats, readerTimer, scratch);
+}
+
+void URLHashTable::searchBatch(const string* urls, int count, OpResult* results){
+    engine->searchBatch(urls, count, results);
+}
+
+void URLHashTable::insertBatch(const string* urls, int count, OpResult* results){
+    engine->insertBatch(urls, count, results);
+}
+
+void URLHashTable::insertBatch(const string* urls, const unsigned long long* hashes, int count, OpResult* results){
+    engine->insertBatch(urls, hashes, count, results);
+}
+
+bool URLHashTable::searchURL(const string& url){
+    return engine->searchURL(url);
+}
+
+bool URLHashTable::insertURL(const string& url){
+    return engine->insertURL(url);
+}
+
+bool URLHashTable::deleteURL(const string& url){
+    return engine->deleteURL(url);
+}
+
+void URLHashTable::compactTombstones(){
+    engine->compactTombstones();
+}
+
+void URLHashTable::displayTable(){
+    engine->displayTable();
+}
+
+void URLHashTable::profileTable(TableProfile& profile, int topClusters){
+    engine->profileTable(profile, topClusters);
+}
+
+void URLHashTable::displayStats(){
+    engine->displayStats();
 }
 
 void URLHashTable::resetStats(){
-    stats.reset();
+    engine->resetStats();
 }
 
 double URLHashTable::getLoadFactor(){
-    return (double)numElements/size;
+    return engine->getLoadFactor();
 }
 
 int URLHashTable::getSize(){
-    return size;
+    return engine->getSize();
 }
 
 int URLHashTable::getNumElements(){
-    return numElements;
+    return engine->getNumElements();
 }
 
-const Statistics& URLHashTable::getStats() const{
-    return stats;
+int URLHashTable::getNumTombstones(){
+    return engine->getNumTombstones();
+}
+
+double URLHashTable::getTombstoneRatio(){
+    return engine->getTombstoneRatio();
+}
+
+bool URLHashTable::isMigrating(){
+    return engine->isMigrating();
+}
+
+HashType URLHashTable::getHashFunction() const{
+    return current_hType;
 }
 
+bool URLHashTable::getKeyEncoding() const{
+    return keyEncoding;
+}
+
+const Statistics& URLHashTable::getStats() const{
+    return engine->getStats();
+}
@@ -0,0 +1,234 @@
+#include "../include/URLKeyCodec.h"
+#include "../include/FastHashes.h"
+
+//Longest prefixes first so "http://www." wins over "http://". The forms
+//missing the ':' appear in the crawl data and are accepted as URLs too
+static const char* const SCHEMES[] = {
+    "https://www.", "http://www.", "https//www.", "http//www.",
+    "https://", "http://", "https//", "http//"
+};
+static const int NUM_SCHEMES = sizeof(SCHEMES)/sizeof(SCHEMES[0]);
+
+URLKeyCodec::URLKeyCodec(){
+}
+
+int URLKeyCodec::schemeCode(const string& url, size_t& prefixLen){
+    return schemeCode(url.data(), url.length(), prefixLen);
+}
+
+int URLKeyCodec::schemeCode(const char* url, size_t len, size_t& prefixLen){
+    for(int i=0; i<NUM_SCHEMES; i++){
+        size_t schemeLen = char_traits<char>::length(SCHEMES[i]);
+        if(len>=schemeLen && char_traits<char>::compare(url, SCHEMES[i], schemeLen)==0){
+            prefixLen = schemeLen;
+            return i+1;
+        }
+    }
+    prefixLen = 0;
+    return 0;
+}
+
+bool URLKeyCodec::hasKnownScheme(const string& url){
+    size_t prefixLen;
+    return schemeCode(url, prefixLen)!=0;
+}
+
+bool URLKeyCodec::hasKnownScheme(const char* url, size_t len){
+    size_t prefixLen;
+    return schemeCode(url, len, prefixLen)!=0;
+}
+
+bool URLKeyCodec::encode(const string& url, string& out, bool intern){
+    bool added;
+    return encode(url, out, intern, added);
+}
+
+bool URLKeyCodec::encode(const string& url, string& out, bool intern, bool& added){
+    size_t prefixLen;
+    int code = schemeCode(url, prefixLen);
+    added = false;
+    
+    out.clear();
+    out.push_back((char)code);
+    if(code==0){
+        out.append(url);
+        return true;
+    }
+    
+    //Host runs up to the first path, query or fragment delimiter
+    size_t hostEnd = url.find_first_of("/?#", prefixLen);
+    if(hostEnd==string::npos){
+        hostEnd = url.size();
+    }
+    const char* host = url.data()+prefixLen;
+    size_t hostLen = hostEnd-prefixLen;
+    
+    unsigned int id;
+    int slot = findSlot(host, hostLen);
+    if(slot!=-1 && index[slot]!=0){
+        id = index[slot]-1;
+    }
+    else if(intern){
+        if((hosts.size()-freeIds.size()+1)*2>index.size()){
+            growIndex();
+            slot = findSlot(host, hostLen);
+        }
+        if(!freeIds.empty()){
+            id = freeIds.back();
+            freeIds.pop_back();
+            hosts[id].assign(host, hostLen);
+        }
+        else{
+            id = hosts.size();
+            hosts.push_back(string(host, hostLen));
+        }
+        index[slot] = id+1;
+        added = true;
+    }
+    else{
+        return false;
+    }
+    
+    //7 bits per byte, high bit set on all but the last
+    while(id>=0x80){
+        out.push_back((char)((id & 0x7F) | 0x80));
+        id >>= 7;
+    }
+    out.push_back((char)id);
+    
+    out.append(url, hostEnd, string::npos);
+    return true;
+}
+
+unsigned long long URLKeyCodec::hostHash(const char* host, size_t len){
+    return FastHashes::wyhash(host, len, 0x9E3779B97F4A7C15ULL);
+}
+
+//Slot holding host, or the empty slot where it would go (-1: no index yet)
+int URLKeyCodec::findSlot(const char* host, size_t len) const{
+    if(index.empty()){
+        return -1;
+    }
+    
+    size_t mask = index.size()-1;
+    size_t slot = hostHash(host, len) & mask;
+    while(index[slot]!=0){
+        const string& stored = hosts[index[slot]-1];
+        if(stored.size()==len && char_traits<char>::compare(stored.data(), host, len)==0){
+            break;
+        }
+        slot = (slot+1) & mask;
+    }
+    return slot;
+}
+
+void URLKeyCodec::growIndex(){
+    vector<unsigned int> old;
+    old.swap(index);
+    index.assign(old.empty() ? 16 : old.size()*2, 0);
+    
+    size_t mask = index.size()-1;
+    for(size_t i=0; i<old.size(); i++){
+        if(old[i]==0){
+            continue;
+        }
+        const string& host = hosts[old[i]-1];
+        size_t slot = hostHash(host.data(), host.size()) & mask;
+        while(index[slot]!=0){
+            slot = (slot+1) & mask;
+        }
+        index[slot] = old[i];
+    }
+}
+
+//Removes id from the index by shifting back any later entry of the same
+//run that may move into the gap, so no tombstones are needed
+void URLKeyCodec::release(unsigned int id){
+    if(id>=hosts.size()){
+        return;
+    }
+    int slot = findSlot(hosts[id].data(), hosts[id].size());
+    if(slot==-1 || index[slot]!=id+1){
+        return;
+    }
+    
+    size_t mask = index.size()-1;
+    size_t gap = slot;
+    size_t next = (gap+1) & mask;
+    while(index[next]!=0){
+        const string& host = hosts[index[next]-1];
+        size_t home = hostHash(host.data(), host.size()) & mask;
+        if(((next-home) & mask)>=((next-gap) & mask)){
+            index[gap] = index[next];
+            gap = next;
+        }
+        next = (next+1) & mask;
+    }
+    index[gap] = 0;
+    
+    string().swap(hosts[id]);
+    freeIds.push_back(id);
+}
+
+string URLKeyCodec::decode(const char* key, size_t len) const{
+    if(len==0){
+        return "";
+    }
+    
+    int code = (unsigned char)key[0];
+    if(code==0 || code>NUM_SCHEMES){
+        return string(key+1, len-1);
+    }
+    
+    size_t pos = 1;
+    unsigned int id;
+    readId(key, len, pos, id);
+    
+    string url = SCHEMES[code-1];
+    if(id<hosts.size()){
+        url += hosts[id];
+    }
+    url.append(key+pos, len-pos);
+    return url;
+}
+
+//Varint host id starting at pos; pos is left just past it
+bool URLKeyCodec::readId(const char* key, size_t len, size_t& pos, unsigned int& id){
+    id = 0;
+    int shift = 0;
+    while(pos<len){
+        unsigned char byte = key[pos++];
+        id |= (unsigned int)(byte & 0x7F) << shift;
+        shift += 7;
+        if((byte & 0x80)==0){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool URLKeyCodec::hostId(const char* key, size_t len, unsigned int& id){
+    int code = len>0 ? (unsigned char)key[0] : 0;
+    if(code==0 || code>NUM_SCHEMES){
+        return false;
+    }
+    size_t pos = 1;
+    return readId(key, len, pos, id);
+}
+
+int URLKeyCodec::getNumHosts() const{
+    return hosts.size()-freeIds.size();
+}
+
+size_t URLKeyCodec::getMemoryBytes() const{
+    size_t bytes = hosts.capacity()*sizeof(string);
+    size_t inlineCapacity = string().capacity();
+    for(size_t i=0; i<hosts.size(); i++){
+        if(hosts[i].capacity()>inlineCapacity){
+            bytes += hosts[i].capacity()+1;
+        }
+    }
+    bytes += index.capacity()*sizeof(unsigned int);
+    bytes += freeIds.capacity()*sizeof(unsigned int);
+    return bytes;
+}
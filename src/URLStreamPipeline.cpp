@@ -0,0 +1,286 @@
+#include "../include/URLStreamPipeline.h"
+#include "../include/MappedURLFile.h"
+#include "../include/HashRegistry.h"
+#include "../include/HashFunctions.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <cstring>
+
+static const char* stageNames[URLStreamPipeline::NUM_STAGES] = {"Read", "Parse", "Hash", "Insert"};
+static const char* queueNames[URLStreamPipeline::NUM_STAGES-1] = {"Read -> Parse", "Parse -> Hash", "Hash -> Insert"};
+
+static double secondsSince(chrono::steady_clock::time_point start){
+    return chrono::duration<double>(chrono::steady_clock::now()-start).count();
+}
+
+URLStreamPipeline::URLStreamPipeline(URLHashTable& target) : table(target){
+    blockBytes = 64*1024;
+    batchSize = 256;
+    queueDepth = 8;
+    
+    tableSize = 0;
+    inserted = 0;
+    wallSeconds = 0;
+    for(int i=0; i<NUM_STAGES; i++){
+        stages[i].name = stageNames[i];
+        stages[i].items = 0;
+        stages[i].bytes = 0;
+        stages[i].busySeconds = 0;
+    }
+    for(int i=0; i<NUM_STAGES-1; i++){
+        queues[i] = PipelineQueue();
+        queues[i].name = queueNames[i];
+    }
+}
+
+void URLStreamPipeline::setBlockBytes(size_t bytes){
+    blockBytes = bytes>0 ? bytes : 1;
+}
+
+void URLStreamPipeline::setBatchSize(int urls){
+    batchSize = urls>0 ? urls : 1;
+}
+
+void URLStreamPipeline::setQueueDepth(size_t items){
+    queueDepth = items>0 ? items : 1;
+}
+
+//Every block but the last ends with a newline, so no line is split between
+//blocks. A line longer than a block is carried until its newline arrives
+void URLStreamPipeline::readStage(ifstream& file, BoundedQueue<string>& out){
+    PipelineStage& stage = stages[STAGE_READ];
+    string carry;
+    
+    while(true){
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        string block;
+        block.swap(carry);
+        size_t kept = block.size();
+        block.resize(kept+blockBytes);
+        file.read(&block[kept], blockBytes);
+        size_t got = (size_t)file.gcount();
+        block.resize(kept+got);
+        stage.bytes += got;
+        
+        if(got<blockBytes){
+            stage.busySeconds += secondsSince(start);
+            if(!block.empty()){
+                stage.items++;
+                out.push(move(block));
+            }
+            break;
+        }
+        
+        size_t cut = block.rfind('\n');
+        if(cut==string::npos){
+            carry.swap(block);
+            stage.busySeconds += secondsSince(start);
+            continue;
+        }
+        carry.assign(block, cut+1, string::npos);
+        block.resize(cut+1);
+        stage.busySeconds += secondsSince(start);
+        
+        stage.items++;
+        out.push(move(block));
+    }
+    out.close();
+}
+
+void URLStreamPipeline::parseStage(BoundedQueue<string>& in, BoundedQueue<URLBatch>& out){
+    PipelineStage& stage = stages[STAGE_PARSE];
+    vector<URLView> views;
+    URLBatch batch;
+    bool firstBlock = true;
+    string block;
+    
+    while(in.pop(block)){
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        const char* begin = block.data();
+        const char* end = begin+block.size();
+        stage.bytes += block.size();
+        
+        //The first line (table size) is whole within the first block
+        if(firstBlock){
+            firstBlock = false;
+            const char* newline = (const char*)memchr(begin, '\n', end-begin);
+            const char* body = newline ? newline+1 : end;
+            tableSize = MappedURLFile::parseTableSize(begin, body);
+            begin = body;
+        }
+        
+        views.clear();
+        MappedURLFile::parseLines(begin, end, views);
+        for(size_t i=0; i<views.size(); i++){
+            batch.urls.push_back(views[i].str());
+            if((int)batch.urls.size()==batchSize){
+                stage.items += batch.urls.size();
+                stage.busySeconds += secondsSince(start);
+                out.push(move(batch));
+                batch = URLBatch();
+                start = chrono::steady_clock::now();
+            }
+        }
+        stage.busySeconds += secondsSince(start);
+    }
+    
+    if(!batch.urls.empty()){
+        stage.items += batch.urls.size();
+        out.push(move(batch));
+    }
+    out.close();
+}
+
+//Uses its own HashFunctions: the instance keeps power tables, so it is not
+//shared with the table's thread. The hashes match the table's
+void URLStreamPipeline::hashStage(BoundedQueue<URLBatch>& in, BoundedQueue<URLBatch>& out){
+    PipelineStage& stage = stages[STAGE_HASH];
+    const HashAlgorithm& algo = HashRegistry::find(table.getHashFunction());
+    HashFunctions hashFunc;
+    bool encoded = table.getKeyEncoding();
+    URLBatch batch;
+    
+    while(in.pop(batch)){
+        if(encoded){
+            out.push(move(batch));
+            continue;
+        }
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        batch.hashes.resize(batch.urls.size());
+        for(size_t i=0; i<batch.urls.size(); i++){
+            const string& url = batch.urls[i];
+            batch.hashes[i] = algo.hash64(hashFunc, url.data(), url.length());
+            stage.bytes += url.length();
+        }
+        stage.items += batch.urls.size();
+        stage.busySeconds += secondsSince(start);
+        out.push(move(batch));
+    }
+    out.close();
+}
+
+void URLStreamPipeline::insertStage(BoundedQueue<URLBatch>& in){
+    PipelineStage& stage = stages[STAGE_INSERT];
+    vector<OpResult> results;
+    URLBatch batch;
+    
+    while(in.pop(batch)){
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int count = batch.urls.size();
+        results.resize(count);
+        if(batch.hashes.empty()){
+            table.insertBatch(&batch.urls[0], count, &results[0]);
+        }
+        else{
+            table.insertBatch(&batch.urls[0], &batch.hashes[0], count, &results[0]);
+        }
+        
+        for(int i=0; i<count; i++){
+            if(results[i].success){
+                inserted++;
+            }
+            stage.bytes += batch.urls[i].length();
+        }
+        stage.items += count;
+        stage.busySeconds += secondsSince(start);
+    }
+}
+
+template <typename T>
+PipelineQueue URLStreamPipeline::queueStats(const char* name, const BoundedQueue<T>& queue){
+    PipelineQueue stats;
+    stats.name = name;
+    stats.capacity = queue.getCapacity();
+    stats.avgOccupancy = queue.getAvgOccupancy();
+    stats.maxOccupancy = queue.getMaxOccupancy();
+    stats.fullWaits = queue.getFullWaits();
+    stats.emptyWaits = queue.getEmptyWaits();
+    return stats;
+}
+
+bool URLStreamPipeline::run(const string& filename){
+    ifstream file(filename, ios::binary);
+    if(!file.is_open()){
+        return false;
+    }
+    
+    tableSize = 0;
+    inserted = 0;
+    for(int i=0; i<NUM_STAGES; i++){
+        stages[i].items = 0;
+        stages[i].bytes = 0;
+        stages[i].busySeconds = 0;
+    }
+    
+    BoundedQueue<string> blocks(queueDepth);
+    BoundedQueue<URLBatch> parsed(queueDepth);
+    BoundedQueue<URLBatch> hashed(queueDepth);
+    
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    thread reader(&URLStreamPipeline::readStage, this, ref(file), ref(blocks));
+    thread parser(&URLStreamPipeline::parseStage, this, ref(blocks), ref(parsed));
+    thread hasher(&URLStreamPipeline::hashStage, this, ref(parsed), ref(hashed));
+    insertStage(hashed);
+    reader.join();
+    parser.join();
+    hasher.join();
+    wallSeconds = secondsSince(start);
+    
+    queues[0] = queueStats(queueNames[0], blocks);
+    queues[1] = queueStats(queueNames[1], parsed);
+    queues[2] = queueStats(queueNames[2], hashed);
+    return true;
+}
+
+int URLStreamPipeline::getTableSize() const{
+    return tableSize;
+}
+
+long URLStreamPipeline::getInserted() const{
+    return inserted;
+}
+
+double URLStreamPipeline::getWallSeconds() const{
+    return wallSeconds;
+}
+
+const PipelineStage& URLStreamPipeline::getStage(int stage) const{
+    return stages[stage];
+}
+
+const PipelineQueue& URLStreamPipeline::getQueue(int queue) const{
+    return queues[queue];
+}
+
+//Busy rate: what the stage could sustain alone. Wall rate: what the whole
+//pipeline delivered; the stage with the lowest busy rate bounds it
+void URLStreamPipeline::displayStats() const{
+    cout << "\nPipeline Stages:" << endl;
+    cout << left << setw(10) << "Stage" << setw(12) << "Items" << setw(12) << "MB"
+         << setw(12) << "Busy (s)" << setw(16) << "Items/s busy" << "MB/s busy" << endl;
+    for(int i=0; i<NUM_STAGES; i++){
+        const PipelineStage& s = stages[i];
+        double mb = s.bytes/1e6;
+        cout << left << setw(10) << s.name << setw(12) << s.items
+             << setw(12) << fixed << setprecision(2) << mb
+             << setw(12) << setprecision(4) << s.busySeconds
+             << setw(16) << setprecision(0) << (s.busySeconds>0 ? s.items/s.busySeconds : 0.0)
+             << setprecision(1) << (s.busySeconds>0 ? mb/s.busySeconds : 0.0) << endl;
+    }
+    
+    cout << "\nQueue Occupancy:" << endl;
+    cout << left << setw(16) << "Queue" << setw(10) << "Capacity" << setw(10) << "Avg"
+         << setw(8) << "Max" << setw(12) << "Full waits" << "Empty waits" << endl;
+    for(int i=0; i<NUM_STAGES-1; i++){
+        const PipelineQueue& q = queues[i];
+        cout << left << setw(16) << q.name << setw(10) << q.capacity
+             << setw(10) << fixed << setprecision(2) << q.avgOccupancy
+             << setw(8) << q.maxOccupancy << setw(12) << q.fullWaits << q.emptyWaits << endl;
+    }
+    
+    cout << "\nWall time: " << setprecision(4) << wallSeconds << " s, "
+         << setprecision(0) << (wallSeconds>0 ? stages[STAGE_INSERT].items/wallSeconds : 0.0)
+         << " URLs/s end to end (" << inserted << " inserted)" << endl;
+}
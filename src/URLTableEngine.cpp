@@ -0,0 +1,3 @@
+#include "../include/URLTableEngine.h"
+
+URLTableEngine::~URLTableEngine(){}
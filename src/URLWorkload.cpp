@@ -0,0 +1,342 @@
+#include "../include/URLWorkload.h"
+#include <cmath>
+
+static const unsigned long long GOLDEN = 0x9E3779B97F4A7C15ULL;
+
+//SplitMix64 finalizer: a bijective, well-mixed 64-bit hash
+static unsigned long long mix64(unsigned long long x){
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+//SplitMix64 stream, seeded per key so every URL is generated independently
+struct SplitMix {
+    unsigned long long state;
+    
+    SplitMix(unsigned long long seed) : state(seed) {}
+    
+    unsigned long long next(){
+        state += GOLDEN;
+        return mix64(state);
+    }
+    
+    double uniform(){
+        return (next() >> 11) * (1.0/9007199254740992.0);
+    }
+    
+    int below(int n){
+        return (int)(next() % n);
+    }
+};
+
+static const char* SYLLABLES[64] = {
+    "an", "bel", "co", "da", "el", "fa", "gal", "ha", "in", "jo", "ka", "lu", "ma", "ne", "or", "pi",
+    "qua", "ra", "si", "to", "ur", "vi", "wa", "xe", "yo", "za", "net", "web", "hub", "lab", "box", "soft",
+    "data", "tech", "news", "shop", "mart", "blog", "cloud", "media", "info", "link", "zone", "base", "star", "line", "nova", "peak",
+    "wave", "pro", "max", "one", "go", "bit", "app", "dev", "ly", "fy", "ex", "ar", "um", "on", "is", "ia"
+};
+
+static const char* WORDS[64] = {
+    "news", "products", "blog", "category", "article", "images", "search", "user", "docs", "help", "en", "video",
+    "wiki", "tag", "page", "2021", "2022", "2023", "2024", "about", "shop", "item", "forum", "thread",
+    "posts", "static", "assets", "media", "files", "download", "api", "v1", "v2", "account", "login", "cart",
+    "sports", "world", "tech", "science", "health", "travel", "music", "movies", "games", "books", "recipes", "reviews",
+    "events", "jobs", "support", "faq", "contact", "team", "press", "legal", "privacy", "terms", "archive", "index",
+    "feed", "store", "community", "learn"
+};
+
+static const char* SUBDOMAINS[6] = {"blog.", "shop.", "m.", "en.", "news.", "api."};
+
+struct WeightedTLD {
+    const char* tld;
+    int weight;  // Percent
+};
+
+static const WeightedTLD TLDS[] = {
+    {".com", 50}, {".org", 9}, {".net", 8}, {".io", 5}, {".edu", 4}, {".gov", 2}, {".co.uk", 5},
+    {".de", 5}, {".fr", 3}, {".jp", 3}, {".info", 2}, {".ca", 2}, {".com.au", 2}
+};
+
+static const char* EXTENSIONS[] = {"", ".html", ".php", ".aspx", ".htm", ".jpg", ".pdf"};
+static const double EXTENSION_CUMULATIVE[] = {0.45, 0.70, 0.80, 0.85, 0.90, 0.95, 1.0};
+
+static const char* PARAMS[8] = {"id", "q", "page", "ref", "lang", "sort", "session", "v"};
+
+//Segments below the last one: 0-5, mostly 1-3
+static const double DEPTH_CUMULATIVE[] = {0.05, 0.25, 0.55, 0.80, 0.92, 1.0};
+
+static const char* SLUG_CHARS = "abcdefghijklmnopqrstuvwxyz0123456789";
+
+//Lowercase letters and digits with the odd inner hyphen; the length is
+//3 plus an exponential tail, capped at maxLen
+static void appendSlug(SplitMix& r, int maxLen, string& out){
+    int len = 3 + (int)(-log(1.0 - r.uniform())*5.0);
+    if(len>maxLen){
+        len = maxLen;
+    }
+    for(int i=0; i<len; i++){
+        if(i>0 && i<len-1 && r.below(100)<8){
+            out.push_back('-');
+        }
+        else{
+            out.push_back(SLUG_CHARS[r.below(36)]);
+        }
+    }
+}
+
+static void appendSegment(SplitMix& r, string& out){
+    if(r.below(100)<55){
+        out += WORDS[r.below(64)];
+    }
+    else{
+        appendSlug(r, 24, out);
+    }
+}
+
+static void appendBase36(unsigned long long value, string& out){
+    static const char* DIGITS = "0123456789abcdefghijklmnopqrstuvwxyz";
+    char digits[16];
+    int n = 0;
+    do{
+        digits[n++] = DIGITS[value%36];
+        value /= 36;
+    } while(value>0);
+    while(n>0){
+        out.push_back(digits[--n]);
+    }
+}
+
+ZipfianGenerator::ZipfianGenerator(long long numItems, double skew){
+    items = numItems>0 ? numItems : 1;
+    theta = skew>0.0001 ? (skew<0.9999 ? skew : 0.9999) : 0.0001;
+    zetan = zeta(items, theta);
+    alpha = 1.0/(1.0-theta);
+    half = 1.0 + pow(0.5, theta);
+    eta = 0;
+    if(items>2){
+        eta = (1.0 - pow(2.0/items, 1.0-theta)) / (1.0 - zeta(2, theta)/zetan);
+    }
+}
+
+//Sum of k^-theta for k = 1..n; past 10^7 terms the tail comes from the
+//Euler-Maclaurin estimate (integral plus endpoint correction)
+double ZipfianGenerator::zeta(long long n, double skew){
+    const long long EXACT_TERMS = 10000000;
+    long long m = n<EXACT_TERMS ? n : EXACT_TERMS;
+    double sum = 0;
+    for(long long k=1; k<=m; k++){
+        sum += pow((double)k, -skew);
+    }
+    if(n>m){
+        sum += (pow((double)n, 1.0-skew) - pow((double)m, 1.0-skew))/(1.0-skew)
+             + (pow((double)n, -skew) - pow((double)m, -skew))/2.0;
+    }
+    return sum;
+}
+
+long long ZipfianGenerator::sample(double u) const{
+    double uz = u*zetan;
+    if(uz<1.0 || items==1){
+        return 0;
+    }
+    if(uz<half || items==2){
+        return 1;
+    }
+    long long rank = (long long)(items*pow(eta*u - eta + 1.0, alpha));
+    return rank<items ? rank : items-1;
+}
+
+long long ZipfianGenerator::getItems() const{
+    return items;
+}
+
+URLCorpus::URLCorpus(long long expectedKeys, unsigned long long corpusSeed)
+    : seed(corpusSeed), numHosts(expectedKeys/50>16 ? expectedKeys/50 : 16), hostPopularity(numHosts, 0.9){
+}
+
+//Host h's name spells h in base 64 with one syllable per digit (at least
+//two), mixed with the seed; its scheme, subdomain and TLD are fixed per host
+void URLCorpus::appendHost(long long host, string& out) const{
+    SplitMix r(mix64(seed ^ (host*GOLDEN)) ^ 0x5851F42D4C957F2DULL);
+    
+    out += r.below(100)<78 ? "https://" : "http://";
+    int sub = r.below(100);
+    if(sub<55){
+        out += "www.";
+    }
+    else if(sub<63){
+        out += SUBDOMAINS[r.below(6)];
+    }
+    
+    unsigned long long v = host;
+    int n = 0;
+    do{
+        out += SYLLABLES[(int)((v%64)*37 + n*11 + seed) & 63];
+        v /= 64;
+        n++;
+    } while(v>0 || n<2);
+    
+    int pick = r.below(100);
+    for(size_t i=0; i<sizeof(TLDS)/sizeof(TLDS[0]); i++){
+        if(pick<TLDS[i].weight || i+1==sizeof(TLDS)/sizeof(TLDS[0])){
+            out += TLDS[i].tld;
+            break;
+        }
+        pick -= TLDS[i].weight;
+    }
+}
+
+//The last segment is "<word or slug>-<key in base 36>" ('~' instead of '-'
+//when absent). Words and slugs hold no '.', '?' or '/', and ids no '-', so
+//the id is the text after the last '-' before the extension or query: two
+//keys never give the same URL, and no corpus URL contains a '~'
+void URLCorpus::url(long long key, bool absent, string& out) const{
+    SplitMix r(mix64(seed*GOLDEN + (unsigned long long)key));
+    out.clear();
+    
+    long long rank = hostPopularity.sample(r.uniform());
+    appendHost((long long)(mix64(rank ^ seed) % (unsigned long long)numHosts), out);
+    
+    double u = r.uniform();
+    int depth = 0;
+    while(u>=DEPTH_CUMULATIVE[depth]){
+        depth++;
+    }
+    for(int i=0; i<depth; i++){
+        out.push_back('/');
+        appendSegment(r, out);
+    }
+    
+    out.push_back('/');
+    appendSegment(r, out);
+    out.push_back(absent ? '~' : '-');
+    appendBase36((unsigned long long)key, out);
+    
+    u = r.uniform();
+    int ext = 0;
+    while(u>=EXTENSION_CUMULATIVE[ext]){
+        ext++;
+    }
+    out += EXTENSIONS[ext];
+    
+    int query = r.below(100);
+    if(query<3){
+        //Tracking parameters: the long tail of URL lengths
+        out += "?utm_source=";
+        out += WORDS[r.below(64)];
+        out += "&utm_medium=";
+        out += WORDS[r.below(64)];
+        out += "&utm_campaign=";
+        appendSlug(r, 60, out);
+        out += "&fbclid=";
+        for(int i=0; i<32; i++){
+            out.push_back(SLUG_CHARS[r.below(36)]);
+        }
+    }
+    else if(query<18){
+        int params = 1 + r.below(3);
+        for(int i=0; i<params; i++){
+            out.push_back(i==0 ? '?' : '&');
+            out += PARAMS[r.below(8)];
+            out.push_back('=');
+            appendSlug(r, 12, out);
+        }
+    }
+}
+
+string URLCorpus::url(long long key) const{
+    string out;
+    url(key, false, out);
+    return out;
+}
+
+long long URLCorpus::getNumHosts() const{
+    return numHosts;
+}
+
+unsigned long long URLCorpus::getSeed() const{
+    return seed;
+}
+
+OperationStream::OperationStream(const URLCorpus& source, long long loaded, const OpMix& mix,
+                                 bool zipf, double theta, unsigned long long streamSeed)
+    : corpus(source), zipfian(zipf), popularity(zipf ? (loaded>0 ? loaded : 1) : 1, theta){
+    double weights[NUM_OP_KINDS];
+    weights[OP_SEARCH_HIT] = mix.searchHit>0 ? mix.searchHit : 0;
+    weights[OP_SEARCH_MISS] = mix.searchMiss>0 ? mix.searchMiss : 0;
+    weights[OP_INSERT] = mix.insert>0 ? mix.insert : 0;
+    weights[OP_DELETE] = mix.remove>0 ? mix.remove : 0;
+    
+    double total = 0;
+    for(int i=0; i<NUM_OP_KINDS; i++){
+        total += weights[i];
+    }
+    if(total<=0){
+        weights[OP_SEARCH_HIT] = total = 1;  //Nothing asked for: all hits
+    }
+    double sum = 0;
+    for(int i=0; i<NUM_OP_KINDS; i++){
+        sum += weights[i]/total;
+        cumulative[i] = sum;
+    }
+    cumulative[NUM_OP_KINDS-1] = 1.0;
+    
+    domain = loaded>0 ? loaded : 1;
+    state = mix64(streamSeed);
+    firstLive = 0;
+    nextKey = loaded>0 ? loaded : 0;
+}
+
+unsigned long long OperationStream::nextRandom(){
+    state += GOLDEN;
+    return mix64(state);
+}
+
+double OperationStream::nextUniform(){
+    return (nextRandom() >> 11) * (1.0/9007199254740992.0);
+}
+
+WorkloadOp OperationStream::next(){
+    WorkloadOp op;
+    double u = nextUniform();
+    int kind = 0;
+    while(kind<NUM_OP_KINDS-1 && u>=cumulative[kind]){
+        kind++;
+    }
+    op.kind = (OpKind)kind;
+    
+    long long live = nextKey-firstLive;
+    if((op.kind==OP_SEARCH_HIT || op.kind==OP_DELETE) && live==0){
+        op.kind = OP_SEARCH_MISS;
+    }
+    
+    switch(op.kind){
+        case OP_SEARCH_HIT: {
+            long long rank = zipfian ? popularity.sample(nextUniform()) : (long long)(nextUniform()*domain);
+            long long hot = (long long)(mix64(rank ^ corpus.getSeed()) % (unsigned long long)domain);
+            //Stored keys map to themselves; deleted ones fold into the window
+            long long offset = (hot-firstLive) % live;
+            op.key = firstLive + (offset<0 ? offset+live : offset);
+            break;
+        }
+        case OP_SEARCH_MISS:
+            op.key = (long long)(nextRandom() & ((1ULL << 40) - 1));
+            break;
+        case OP_INSERT:
+            op.key = nextKey++;
+            break;
+        default:
+            op.key = firstLive++;
+            break;
+    }
+    return op;
+}
+
+void OperationStream::url(const WorkloadOp& op, string& out) const{
+    corpus.url(op.key, op.kind==OP_SEARCH_MISS, out);
+}
+
+long long OperationStream::getStored() const{
+    return nextKey-firstLive;
+}
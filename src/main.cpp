@@ -1,86 +1,54 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
 #include <iomanip>
 #include <limits>
 #include <vector>
+#include <thread>
 #include "../include/URLHashTable.h"
+#include "../include/CuckooHashTable.h"
+#include "../include/MappedURLFile.h"
+#include "../include/HashRegistry.h"
+#include "../include/OpTrace.h"
 
 using namespace std;
 
 //Structure to hold test results
 struct TestResult {
+    string engine;
     int tableSize;
     double loadFactor;
     double avgComparisons;
     int maxComparisons;
     double avgTime;
-    int numQueries;
+    long long numQueries;
 };
 
-//Helper function
-bool isValidURL(const string& url) {
-    if(url.length() < 6) return false;
-    
-    if(url.length() >= 7 && url.substr(0, 7) == "http://") return true;
-    if(url.length() >= 6 && url.substr(0, 6) == "http//") return true;
-    if(url.length() >= 8 && url.substr(0, 8) == "https://") return true;
-    if(url.length() >= 7 && url.substr(0, 7) == "https//") return true;
-    
-    return false;
+//Engines the batch test can build; both share the insert/stats interface
+URLHashTable* makeTable(URLHashTable*, int size, HashType hashType, ProbingMethod probingType) {
+    URLHashTable* hashTable = new URLHashTable(size);
+    hashTable->setHashFunction(hashType);
+    hashTable->setProbingMethod(probingType);
+    return hashTable;
 }
 
-//Function to load URLs from CSV file
-vector<string> loadURLsFromFile(const string& filename, int& tableSize) {
-    vector<string> urls;
-    ifstream inputFile(filename);
-    
-    if(!inputFile.is_open()){
-        cout << "Error opening file: " << filename << endl;
-        return urls;
-    }
-    
-    //Read table size from first line
-    string line;
-    if(getline(inputFile, line)){
-        stringstream ss(line);
-        ss >> tableSize;
-    }
-    
-    //Read all URLs
-    while(getline(inputFile, line)){
-        stringstream ss(line);
-        string url;
-        
-        while(getline(ss, url, ',')){
-            size_t start = url.find_first_not_of(" \t\r\n");
-            size_t end = url.find_last_not_of(" \t\r\n");
-            
-            if(start != string::npos && end != string::npos){
-                url = url.substr(start, end - start + 1);
-            }
-            
-            if(!url.empty() && isValidURL(url)){
-                urls.push_back(url);
-            }
-        }
-    }
-    
-    inputFile.close();
-    return urls;
+CuckooHashTable* makeTable(CuckooHashTable*, int size, HashType hashType, ProbingMethod) {
+    CuckooHashTable* hashTable = new CuckooHashTable(size);
+    hashTable->setHashFunction(hashType);
+    return hashTable;
 }
 
 //Function to run a single test
-TestResult runTest(int size, const vector<string>& urls, HashType hashType, ProbingMethod probingType) {
-    URLHashTable* hashTable = new URLHashTable(size);
-    hashTable->setHashFunction(hashType);
-    hashTable->setProbingMethod(probingType);
+template <typename Table>
+TestResult runTest(int size, const vector<URLView>& urls, HashType hashType, ProbingMethod probingType, const string& engineName) {
+    Table* hashTable = makeTable((Table*)0, size, hashType, probingType);
     
     int counter = 0;
+    string url;
     
     //Insert all URLs
-    for(const string& url : urls){
+    for(const URLView& view : urls){
+        url.assign(view.data, view.len);
         if(hashTable->insertURL(url)){
             counter++;
         }
@@ -92,6 +60,7 @@ TestResult runTest(int size, const vector<string>& urls, HashType hashType, Prob
     
     //Collect stats
     TestResult result;
+    result.engine = engineName;
     result.tableSize = size;
     result.loadFactor = hashTable->getLoadFactor();
     result.avgComparisons = hashTable->getStats().getAvgComparisons();
@@ -111,7 +80,13 @@ int main(){
     cout << "Enter CSV filename: ";
     getline(cin, filename);
     
-    vector<string> urls = loadURLsFromFile(filename, originalSize);
+    //URLs stay in the mapped file; each is copied only when it is inserted
+    MappedURLFile urlFile;
+    if(!urlFile.open(filename, (int)thread::hardware_concurrency())){
+        cout << "Error opening file: " << filename << endl;
+    }
+    originalSize = urlFile.getTableSize();
+    const vector<URLView>& urls = urlFile.getURLs();
     
     if(urls.empty()){
         cout << "No valid URLs found in file. Exiting." << endl;
@@ -145,71 +120,90 @@ int main(){
         }
     }
     
-    //Get hash function type
+    //Get hash function type (menu order comes from the hash registry)
+    int numHashes = HashRegistry::count();
     int hashChoice;
     while(true){
         cout << "\nSelect hash function:" << endl;
-        cout << "1. Bitwise Mixing Hash" << endl;
-        cout << "2. Polynomial Rolling Hash" << endl;
-        cout << "3. Universal Hashing" << endl;
-        cout << "Enter choice (1, 2, or 3): ";
+        for(int i = 0; i < numHashes; i++){
+            cout << i+1 << ". " << HashRegistry::get(i).name << endl;
+        }
+        cout << "Enter choice (1-" << numHashes << "): ";
         
         if(cin >> hashChoice){
-            if(hashChoice >= 1 && hashChoice <= 3){
+            if(hashChoice >= 1 && hashChoice <= numHashes){
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
                 break;
             }
             else{
-                cout << "Only enter 1, 2, or 3." << endl;
+                cout << "Only enter 1 to " << numHashes << "." << endl;
             }
         }
         else{
-            cout << "Only enter 1, 2, or 3." << endl;
+            cout << "Only enter 1 to " << numHashes << "." << endl;
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
         }
     }
     
-    HashType hashType;
-    if(hashChoice == 1){
-        hashType = BITWISE_HASH;
-        cout << "Using Bitwise Mixing Hash" << endl;
-    }
-    else if(hashChoice == 2){
-        hashType = POLYNOMIAL_HASH;
-        cout << "Using Polynomial Rolling Hash" << endl;
-    }
-    else{
-        hashType = UNIVERSAL_HASH;
-        cout << "Using Universal Hashing" << endl;
+    const HashAlgorithm& hashAlgo = HashRegistry::get(hashChoice-1);
+    HashType hashType = hashAlgo.type;
+    cout << "Using " << hashAlgo.name;
+    if(hashAlgo.implementation){
+        cout << " [" << hashAlgo.implementation() << "]";
     }
+    cout << endl;
     
-    //Get probing method
+    //Get probing method. Cuckoo hashing has no probing, tombstones or
+    //growth to explore interactively, so it is offered for the batch test
+    int numEngines = mode == 2 ? 4 : 3;
     int probingChoice;
     while(true){
         cout << "\nSelect probing method:" << endl;
         cout << "1. Linear Probing" << endl;
         cout << "2. Quadratic Probing" << endl;
-        cout << "Enter choice (1 or 2): ";
+        cout << "3. Robin Hood Probing" << endl;
+        if(numEngines == 4){
+            cout << "4. Cuckoo Hashing (two 4-slot buckets)" << endl;
+        }
+        cout << "Enter choice (1-" << numEngines << "): ";
         
         if(cin >> probingChoice){
-            if(probingChoice == 1 || probingChoice == 2){
+            if(probingChoice >= 1 && probingChoice <= numEngines){
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
                 break;
             }
             else{
-                cout << "Only enter 1 or 2." << endl;
+                cout << "Only enter 1 to " << numEngines << "." << endl;
             }
         }
         else{
-            cout << "Only enter 1 or 2." << endl;
+            cout << "Only enter 1 to " << numEngines << "." << endl;
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
         }
     }
     
-    ProbingMethod probingType = (probingChoice == 1) ? LINEAR_PROBING : QUADRATIC_PROBING;
-    cout << "Using " << (probingChoice == 1 ? "Linear" : "Quadratic") << " Probing" << endl;
+    ProbingMethod probingType = LINEAR_PROBING;
+    bool useCuckoo = false;
+    string engineName;
+    if(probingChoice == 1){
+        probingType = LINEAR_PROBING;
+        engineName = "Linear Probing";
+    }
+    else if(probingChoice == 2){
+        probingType = QUADRATIC_PROBING;
+        engineName = "Quadratic Probing";
+    }
+    else if(probingChoice == 3){
+        probingType = ROBIN_HOOD_PROBING;
+        engineName = "Robin Hood Probing";
+    }
+    else{
+        useCuckoo = true;
+        engineName = "Cuckoo Hashing";
+    }
+    cout << "Using " << engineName << endl;
     
     if(mode == 1){
         int size;
@@ -217,37 +211,74 @@ int main(){
         cin >> size;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
         
+        double maxLoad;
+        cout << "Enter max load factor for automatic growth (0 for fixed size): ";
+        if(!(cin >> maxLoad) || maxLoad < 0){
+            maxLoad = 0;
+            cin.clear();
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        
+        string encodeChoice;
+        cout << "Encode URL keys as scheme code + interned host? (y/n): ";
+        getline(cin, encodeChoice);
+        
+        //Recorded traces replay with trace_replay (binary when the name ends in .bin)
+        string traceName;
+        cout << "Record operations to a trace file (Enter to skip): ";
+        getline(cin, traceName);
+        TraceWriter trace;
+        if(!traceName.empty()){
+            if(trace.open(traceName, TraceWriter::isBinaryName(traceName))){
+                cout << "Recording to " << traceName << endl;
+            }
+            else{
+                cout << "Error opening file: " << traceName << endl;
+            }
+        }
+        
         URLHashTable* hashTable = new URLHashTable(size);
         hashTable->setHashFunction(hashType);
         hashTable->setProbingMethod(probingType);
+        hashTable->setMaxLoadFactor(maxLoad);
+        hashTable->setKeyEncoding(encodeChoice=="y" || encodeChoice=="Y");
+        
+        //Interactive mode reports every operation; batch mode stays silent
+        ConsoleObserver console;
+        hashTable->setObserver(&console);
         
         int counter = 0;
         
         //Insert URLs
         cout << "\nInserting URLs into hash table..." << endl;
-        for(const string& url : urls){
+        string url;
+        for(const URLView& view : urls){
+            url.assign(view.data, view.len);
+            trace.write(TRACE_INSERT, url);
             if(hashTable->insertURL(url)){
                 counter++;
             }
         }
         
-        cout << "\nHash table size is: " << size << endl;
+        cout << "\nHash table size is: " << hashTable->getSize() << endl;
         cout << "Total URLs inserted: " << counter << endl;
         
         // Interactive command loop
         do{
             cout << "\nAvailable Commands" << endl;
             cout << "hashSearch,<URL>" << endl;
+            cout << "hashInsert,<URL>" << endl;
             cout << "hashDelete,<URL>" << endl;
             cout << "hashDisplay" << endl;
+            cout << "hashProfile" << endl;
+            cout << "hashProfile,<CSV file>" << endl;
             cout << "hashStats" << endl;
             cout << "hashReset" << endl;
+            cout << "hashCompact" << endl;
             cout << "End" << endl;
             cout << "\nEnter command:" << endl;
             string cLine;
-            getline(cin, cLine);
-            
-            if(cLine=="End"){
+            if(!getline(cin, cLine) || cLine=="End"){
                 break;
             }
             
@@ -258,6 +289,11 @@ int main(){
                 if(cLine=="hashDisplay"){
                     hashTable->displayTable();
                 }
+                else if(cLine=="hashProfile"){
+                    TableProfile profile;
+                    hashTable->profileTable(profile, 10);
+                    profile.display();
+                }
                 else if(cLine=="hashStats"){
                     hashTable->displayStats();
                 }
@@ -265,6 +301,12 @@ int main(){
                     hashTable->resetStats();
                     cout << "Stats have been reset." << endl;
                 }
+                else if(cLine=="hashCompact"){
+                    trace.write(TRACE_COMPACT, "");
+                    int removed = hashTable->getNumTombstones();
+                    hashTable->compactTombstones();
+                    cout << "Removed " << (removed - hashTable->getNumTombstones()) << " tombstones." << endl;
+                }
                 else{
                     cout << "Enter a valid command." << endl;
                 }
@@ -275,14 +317,39 @@ int main(){
                 
                 if(command=="hashSearch"){
                     if(!url.empty()){
+                        trace.write(TRACE_SEARCH, url);
                         hashTable->searchURL(url);
                     }
                     else{
                         cout << "Enter a valid URL." << endl;
                     }
                 }
+                else if(command=="hashInsert"){
+                    if(!url.empty()){
+                        trace.write(TRACE_INSERT, url);
+                        if(hashTable->insertURL(url)){
+                            counter++;
+                        }
+                    }
+                    else{
+                        cout << "Enter a valid URL." << endl;
+                    }
+                }
+                else if(command=="hashProfile"){
+                    TableProfile profile;
+                    hashTable->profileTable(profile, 10);
+                    ofstream profileFile(url);
+                    if(profileFile.is_open()){
+                        profile.writeCSV(profileFile);
+                        cout << "Profile written to " << url << endl;
+                    }
+                    else{
+                        cout << "Error opening file: " << url << endl;
+                    }
+                }
                 else if(command=="hashDelete"){
                     if(!url.empty()){
+                        trace.write(TRACE_DELETE, url);
                         bool found = hashTable->searchURL(url);
                         if(found){
                             hashTable->deleteURL(url);
@@ -299,6 +366,11 @@ int main(){
             }
         }while(true);
         
+        if(trace.isOpen()){
+            trace.close();
+            cout << "\nRecorded " << trace.getCount() << " operations to " << traceName << endl;
+        }
+        
         cout << "\nFinal Stats" << endl;
         hashTable->displayStats();
         
@@ -334,7 +406,13 @@ int main(){
             cout << "TEST #" << (i+1) << " - Table Size: " << size << endl;
             cout << "Expected Load Factor: " << fixed << setprecision(4) << expectedLoadFactor << endl;
             
-            TestResult result = runTest(size, urls, hashType, probingType);
+            TestResult result;
+            if(useCuckoo){
+                result = runTest<CuckooHashTable>(size, urls, hashType, probingType, engineName);
+            }
+            else{
+                result = runTest<URLHashTable>(size, urls, hashType, probingType, engineName);
+            }
             results.push_back(result);
             
             //Pause between tests
@@ -347,6 +425,8 @@ int main(){
         //Display summary
         cout << "\n\n" << endl;
         cout << "BATCH TEST SUMMARY" << endl;
+        cout << "Hash Function: " << hashAlgo.name << endl;
+        cout << "Engine: " << engineName << endl;
         
         //Find best and worst based on average comparisons
         int bestIdx = 0;
@@ -383,6 +463,7 @@ int main(){
         //Display best performance
         cout << "BEST PERFORMANCE (Lowest Average Comparisons):" << endl;
         cout << fixed << setprecision(4);
+        cout << "Engine:               " << results[bestIdx].engine << endl;
         cout << "Table Size:           " << results[bestIdx].tableSize << endl;
         cout << "Load Factor:          " << results[bestIdx].loadFactor << endl;
         cout << "Avg Comparisons:      " << results[bestIdx].avgComparisons << endl;
@@ -394,6 +475,7 @@ int main(){
         
         cout << "WORST PERFORMANCE (Highest Average Comparisons):" << endl;
         cout << fixed << setprecision(4);
+        cout << "Engine:               " << results[worstIdx].engine << endl;
         cout << "Table Size:           " << results[worstIdx].tableSize << endl;
         cout << "Load Factor:          " << results[worstIdx].loadFactor << endl;
         cout << "Avg Comparisons:      " << results[worstIdx].avgComparisons << endl;
@@ -0,0 +1,131 @@
+// Regression test: quadratic probing with growth, compaction and reduction
+// changes must keep every stored URL findable. Growing used to double the
+// table to sizes the i*i sequence only partly covers, and an entry that
+// found no slot while being moved was dropped
+//
+// Build from the repository root with every src/*.cpp except main.cpp:
+//   g++ -std=c++11 -pthread -Iinclude -o quadratic_growth_test
+//       test/quadratic_growth_test.cpp <src files>
+// Exits with 1 if any check fails
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/URLHashTable.h"
+#include "../include/SlotReducer.h"
+
+using namespace std;
+
+//Counts URLs the table gave up on
+class FullCounter : public TableObserver {
+public:
+    int full;
+    FullCounter() : full(0) {}
+    void onTableFull(const string&) { full++; }
+};
+
+int failures = 0;
+
+void check(bool ok, const string& what, int startSize) {
+    if(!ok){
+        cout << "FAIL (start size " << startSize << "): " << what << endl;
+        failures++;
+    }
+}
+
+//Number of urls the table finds
+int countFound(URLHashTable& table, const vector<string>& urls) {
+    int found = 0;
+    for(const string& url : urls){
+        if(table.search(url).success){
+            found++;
+        }
+    }
+    return found;
+}
+
+void runCase(int startSize, int numURLs) {
+    URLHashTable table(startSize);
+    FullCounter counter;
+    table.setProbingMethod(QUADRATIC_PROBING);
+    table.setObserver(&counter);
+    table.setMaxLoadFactor(0.9);
+    table.setTombstoneThreshold(0);
+    
+    vector<string> urls;
+    for(int i = 0; i < numURLs; i++){
+        urls.push_back("http://www.site" + to_string(i % 97) + ".com/page/" + to_string(i));
+    }
+    
+    int inserted = 0;
+    for(const string& url : urls){
+        if(table.insertURL(url)){
+            inserted++;
+        }
+    }
+    check(inserted == numURLs, "inserts failed below the max load factor", startSize);
+    check(countFound(table, urls) == numURLs, "stored URLs lost during growth", startSize);
+    
+    //Delete every third URL and compact in place
+    vector<string> kept;
+    for(int i = 0; i < numURLs; i++){
+        if(i % 3 == 0){
+            table.deleteURL(urls[i]);
+        }
+        else{
+            kept.push_back(urls[i]);
+        }
+    }
+    table.compactTombstones();
+    check(countFound(table, kept) == (int)kept.size(), "stored URLs lost by compaction", startSize);
+    check(table.getNumElements() == (int)kept.size(), "element count wrong after compaction", startSize);
+    
+    ReductionMethod methods[] = {REDUCE_FASTRANGE, REDUCE_POW2, REDUCE_MOD};
+    for(ReductionMethod method : methods){
+        table.setReduction(method);
+        check(countFound(table, kept) == (int)kept.size(),
+              string("stored URLs lost switching to ") + SlotReducer::methodName(method), startSize);
+    }
+    
+    check(counter.full == 0, "table reported full", startSize);
+}
+
+int main() {
+    //Power-of-two, small odd, and sizes that double to non-powers of two
+    int startSizes[] = {32, 7, 100, 1000, 1021};
+    for(int startSize : startSizes){
+        runCase(startSize, 20000);
+    }
+    
+    //A full power-of-two table without growth: every slot is reachable
+    URLHashTable full(64);
+    full.setProbingMethod(QUADRATIC_PROBING);
+    int inserted = 0;
+    for(int i = 0; i < 64; i++){
+        if(full.insert("http://full.example/" + to_string(i)).success){
+            inserted++;
+        }
+    }
+    check(inserted == 64, "power-of-two table could not fill every slot", 64);
+    
+    //A full linear table switched to quadratic probing keeps every URL,
+    //even where the i*i sequence cannot reach every slot at that size
+    int switchSizes[] = {7, 11, 100, 101, 1000};
+    for(int size : switchSizes){
+        URLHashTable table(size);
+        vector<string> urls;
+        for(int i = 0; i < size; i++){
+            urls.push_back("http://switch.example/" + to_string(i));
+            table.insert(urls.back());
+        }
+        table.setProbingMethod(QUADRATIC_PROBING);
+        check(countFound(table, urls) == size, "stored URLs lost switching a full table to quadratic", size);
+    }
+    
+    if(failures > 0){
+        cout << failures << " check(s) failed" << endl;
+        return 1;
+    }
+    cout << "All quadratic growth checks passed" << endl;
+    return 0;
+}